@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Count heap allocations of the whole process, including those made by
+ * wlroots, pixman, cairo and friends, by interposing the malloc family.
+ * The allocator proper is reached through the glibc internal entry points
+ * which avoids the dlsym() bootstrap problem. On other libc's the counter
+ * simply stays at zero.
+ */
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "bench.h"
+
+static atomic_uint_fast64_t nr_allocs;
+
+#if HAVE_LIBC_MALLOC
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t nmemb, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *
+malloc(size_t size)
+{
+	atomic_fetch_add_explicit(&nr_allocs, 1, memory_order_relaxed);
+	return __libc_malloc(size);
+}
+
+void *
+calloc(size_t nmemb, size_t size)
+{
+	atomic_fetch_add_explicit(&nr_allocs, 1, memory_order_relaxed);
+	return __libc_calloc(nmemb, size);
+}
+
+void *
+realloc(void *ptr, size_t size)
+{
+	atomic_fetch_add_explicit(&nr_allocs, 1, memory_order_relaxed);
+	return __libc_realloc(ptr, size);
+}
+#endif
+
+uint64_t
+bench_alloc_count(void)
+{
+	return atomic_load_explicit(&nr_allocs, memory_order_relaxed);
+}
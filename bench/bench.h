@@ -0,0 +1,48 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_BENCH_H
+#define LABWC_BENCH_H
+#include <stdint.h>
+#include <wayland-util.h>
+
+/**
+ * struct bench_stat - latency samples and allocation count for one metric
+ * @name: metric name as printed in the report
+ * @samples: array of uint64_t durations in nanoseconds
+ * @allocs: number of heap allocations made while sampling
+ */
+struct bench_stat {
+	const char *name;
+	struct wl_array samples;
+	uint64_t allocs;
+	struct wl_list link; /* stats.c:stats */
+};
+
+/* alloc.c */
+uint64_t bench_alloc_count(void);
+
+/* stats.c */
+uint64_t bench_now(void);
+struct bench_stat *bench_stat_get(const char *name);
+void bench_stat_add(struct bench_stat *stat, uint64_t start_ns,
+	uint64_t start_allocs);
+void bench_stats_print(void);
+void bench_stats_finish(void);
+
+/*
+ * client.c - body of a synthetic xdg-shell client process
+ *
+ * The client reads newline terminated commands from @cmd_fd and answers
+ * each one with "ok\n" on @reply_fd once the compositor has processed the
+ * resulting requests. Commands:
+ *   connect <socket>    connect to the compositor
+ *   map <n>             map n toplevels
+ *   unmap               unmap all toplevels and the layer-shell bar
+ *   bar                 map a layer-shell bar with an exclusive zone
+ *   tick                redraw the bar, re-sending its unchanged state
+ *   title <i> <text>    set title of toplevel i
+ *   sync                ack pending configures and commit new buffers
+ *   quit                disconnect and exit
+ */
+void bench_client_main(int cmd_fd, int reply_fd);
+
+#endif /* LABWC_BENCH_H */
@@ -0,0 +1,383 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <wayland-client.h>
+#include "bench.h"
+#include "wlr-layer-shell-unstable-v1-client-protocol.h"
+#include "xdg-shell-client-protocol.h"
+
+#define DEFAULT_WIDTH 640
+#define DEFAULT_HEIGHT 480
+#define BAR_HEIGHT 24
+
+struct window {
+	struct wl_surface *surface;
+	struct xdg_surface *xdg_surface;
+	struct xdg_toplevel *toplevel;
+	int pending_width;
+	int pending_height;
+};
+
+/* A panel that redraws itself like a clock or CPU meter would */
+struct bar {
+	struct wl_surface *surface;
+	struct zwlr_layer_surface_v1 *layer_surface;
+	int width;
+};
+
+static struct {
+	struct wl_display *display;
+	struct wl_registry *registry;
+	struct wl_compositor *compositor;
+	struct wl_shm *shm;
+	struct xdg_wm_base *wm_base;
+	struct zwlr_layer_shell_v1 *layer_shell;
+	struct window *windows;
+	struct bar bar;
+	int nr_windows;
+	unsigned int nr_buffers;
+} client;
+
+static void
+die(const char *msg)
+{
+	perror(msg);
+	_exit(EXIT_FAILURE);
+}
+
+static void
+handle_buffer_release(void *data, struct wl_buffer *buffer)
+{
+	wl_buffer_destroy(buffer);
+}
+
+static const struct wl_buffer_listener buffer_listener = {
+	.release = handle_buffer_release,
+};
+
+/*
+ * The contents of the buffer do not matter to the compositor, so the shm
+ * file is left zero-filled and never mapped on the client side.
+ */
+static struct wl_buffer *
+create_buffer(int width, int height)
+{
+	int stride = width * 4;
+	int size = stride * height;
+
+	char name[64];
+	snprintf(name, sizeof(name), "/labwc-bench-%d-%u", getpid(),
+		client.nr_buffers++);
+	int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0) {
+		die("shm_open");
+	}
+	shm_unlink(name);
+	if (ftruncate(fd, size) < 0) {
+		die("ftruncate");
+	}
+
+	struct wl_shm_pool *pool = wl_shm_create_pool(client.shm, fd, size);
+	struct wl_buffer *buffer = wl_shm_pool_create_buffer(pool, 0,
+		width, height, stride, WL_SHM_FORMAT_XRGB8888);
+	wl_shm_pool_destroy(pool);
+	close(fd);
+
+	wl_buffer_add_listener(buffer, &buffer_listener, NULL);
+	return buffer;
+}
+
+static void
+handle_toplevel_configure(void *data, struct xdg_toplevel *toplevel,
+		int32_t width, int32_t height, struct wl_array *states)
+{
+	struct window *window = data;
+	window->pending_width = width ? width : DEFAULT_WIDTH;
+	window->pending_height = height ? height : DEFAULT_HEIGHT;
+}
+
+static void
+handle_toplevel_close(void *data, struct xdg_toplevel *toplevel)
+{
+	/* Windows live until the driver unmaps them */
+}
+
+static const struct xdg_toplevel_listener toplevel_listener = {
+	.configure = handle_toplevel_configure,
+	.close = handle_toplevel_close,
+};
+
+static void
+handle_surface_configure(void *data, struct xdg_surface *xdg_surface,
+		uint32_t serial)
+{
+	struct window *window = data;
+	xdg_surface_ack_configure(xdg_surface, serial);
+	wl_surface_attach(window->surface, create_buffer(window->pending_width,
+		window->pending_height), 0, 0);
+	wl_surface_damage_buffer(window->surface, 0, 0,
+		window->pending_width, window->pending_height);
+	wl_surface_commit(window->surface);
+}
+
+static const struct xdg_surface_listener xdg_surface_listener = {
+	.configure = handle_surface_configure,
+};
+
+static void
+handle_wm_base_ping(void *data, struct xdg_wm_base *wm_base, uint32_t serial)
+{
+	xdg_wm_base_pong(wm_base, serial);
+}
+
+static const struct xdg_wm_base_listener wm_base_listener = {
+	.ping = handle_wm_base_ping,
+};
+
+static void
+handle_layer_surface_configure(void *data,
+		struct zwlr_layer_surface_v1 *layer_surface, uint32_t serial,
+		uint32_t width, uint32_t height)
+{
+	struct bar *bar = data;
+	bar->width = width ? width : DEFAULT_WIDTH;
+	zwlr_layer_surface_v1_ack_configure(layer_surface, serial);
+}
+
+static void
+handle_layer_surface_closed(void *data,
+		struct zwlr_layer_surface_v1 *layer_surface)
+{
+	/* The bar lives until the driver unmaps it */
+}
+
+static const struct zwlr_layer_surface_v1_listener layer_surface_listener = {
+	.configure = handle_layer_surface_configure,
+	.closed = handle_layer_surface_closed,
+};
+
+static void
+handle_global(void *data, struct wl_registry *registry, uint32_t name,
+		const char *interface, uint32_t version)
+{
+	if (!strcmp(interface, wl_compositor_interface.name)) {
+		client.compositor = wl_registry_bind(registry, name,
+			&wl_compositor_interface, 4);
+	} else if (!strcmp(interface, wl_shm_interface.name)) {
+		client.shm = wl_registry_bind(registry, name,
+			&wl_shm_interface, 1);
+	} else if (!strcmp(interface, xdg_wm_base_interface.name)) {
+		/* v1 keeps the set of toplevel events to configure/close */
+		client.wm_base = wl_registry_bind(registry, name,
+			&xdg_wm_base_interface, 1);
+		xdg_wm_base_add_listener(client.wm_base, &wm_base_listener,
+			NULL);
+	} else if (!strcmp(interface, zwlr_layer_shell_v1_interface.name)) {
+		client.layer_shell = wl_registry_bind(registry, name,
+			&zwlr_layer_shell_v1_interface, 1);
+	}
+}
+
+static void
+handle_global_remove(void *data, struct wl_registry *registry, uint32_t name)
+{
+	/* nop */
+}
+
+static const struct wl_registry_listener registry_listener = {
+	.global = handle_global,
+	.global_remove = handle_global_remove,
+};
+
+static void
+roundtrip(void)
+{
+	if (wl_display_roundtrip(client.display) < 0) {
+		die("wl_display_roundtrip");
+	}
+}
+
+static void
+client_connect(const char *socket)
+{
+	client.display = wl_display_connect(socket);
+	if (!client.display) {
+		die("wl_display_connect");
+	}
+	client.registry = wl_display_get_registry(client.display);
+	wl_registry_add_listener(client.registry, &registry_listener, NULL);
+	roundtrip();
+	if (!client.compositor || !client.shm || !client.wm_base) {
+		fprintf(stderr, "bench client: missing globals\n");
+		_exit(EXIT_FAILURE);
+	}
+}
+
+static void
+map_windows(int nr)
+{
+	client.windows = realloc(client.windows,
+		(client.nr_windows + nr) * sizeof(*client.windows));
+	if (!client.windows) {
+		die("realloc");
+	}
+	for (int i = 0; i < nr; i++) {
+		struct window *window = &client.windows[client.nr_windows++];
+		window->pending_width = DEFAULT_WIDTH;
+		window->pending_height = DEFAULT_HEIGHT;
+		window->surface = wl_compositor_create_surface(client.compositor);
+		window->xdg_surface = xdg_wm_base_get_xdg_surface(
+			client.wm_base, window->surface);
+		xdg_surface_add_listener(window->xdg_surface,
+			&xdg_surface_listener, window);
+		window->toplevel = xdg_surface_get_toplevel(window->xdg_surface);
+		xdg_toplevel_add_listener(window->toplevel, &toplevel_listener,
+			window);
+
+		char title[32];
+		snprintf(title, sizeof(title), "bench-%d", client.nr_windows);
+		xdg_toplevel_set_title(window->toplevel, title);
+		xdg_toplevel_set_app_id(window->toplevel, "labwc-bench");
+		wl_surface_commit(window->surface);
+	}
+	/* First roundtrip delivers the configures, the second the buffers */
+	roundtrip();
+	roundtrip();
+}
+
+/*
+ * Every frame re-sends the complete layer-surface state along with a new
+ * buffer, the way many bars do, even though only the contents changed.
+ */
+static void
+bar_draw(void)
+{
+	struct bar *bar = &client.bar;
+	zwlr_layer_surface_v1_set_anchor(bar->layer_surface,
+		ZWLR_LAYER_SURFACE_V1_ANCHOR_TOP
+		| ZWLR_LAYER_SURFACE_V1_ANCHOR_LEFT
+		| ZWLR_LAYER_SURFACE_V1_ANCHOR_RIGHT);
+	zwlr_layer_surface_v1_set_size(bar->layer_surface, 0, BAR_HEIGHT);
+	zwlr_layer_surface_v1_set_exclusive_zone(bar->layer_surface,
+		BAR_HEIGHT);
+	wl_surface_attach(bar->surface, create_buffer(bar->width, BAR_HEIGHT),
+		0, 0);
+	wl_surface_damage_buffer(bar->surface, 0, 0, bar->width, BAR_HEIGHT);
+	wl_surface_commit(bar->surface);
+	roundtrip();
+}
+
+static void
+bar_map(void)
+{
+	struct bar *bar = &client.bar;
+	if (!client.layer_shell || bar->surface) {
+		return;
+	}
+	bar->surface = wl_compositor_create_surface(client.compositor);
+	bar->layer_surface = zwlr_layer_shell_v1_get_layer_surface(
+		client.layer_shell, bar->surface, NULL,
+		ZWLR_LAYER_SHELL_V1_LAYER_TOP, "labwc-bench");
+	zwlr_layer_surface_v1_add_listener(bar->layer_surface,
+		&layer_surface_listener, bar);
+	zwlr_layer_surface_v1_set_anchor(bar->layer_surface,
+		ZWLR_LAYER_SURFACE_V1_ANCHOR_TOP
+		| ZWLR_LAYER_SURFACE_V1_ANCHOR_LEFT
+		| ZWLR_LAYER_SURFACE_V1_ANCHOR_RIGHT);
+	zwlr_layer_surface_v1_set_size(bar->layer_surface, 0, BAR_HEIGHT);
+	wl_surface_commit(bar->surface);
+	/* Wait for the initial configure before attaching a buffer */
+	roundtrip();
+	bar_draw();
+}
+
+static void
+bar_unmap(void)
+{
+	struct bar *bar = &client.bar;
+	if (!bar->surface) {
+		return;
+	}
+	zwlr_layer_surface_v1_destroy(bar->layer_surface);
+	wl_surface_destroy(bar->surface);
+	bar->surface = NULL;
+	bar->layer_surface = NULL;
+}
+
+static void
+unmap_windows(void)
+{
+	for (int i = 0; i < client.nr_windows; i++) {
+		struct window *window = &client.windows[i];
+		xdg_toplevel_destroy(window->toplevel);
+		xdg_surface_destroy(window->xdg_surface);
+		wl_surface_destroy(window->surface);
+	}
+	client.nr_windows = 0;
+	bar_unmap();
+	roundtrip();
+}
+
+static void
+set_title(int index, const char *title)
+{
+	if (index < 0 || index >= client.nr_windows) {
+		return;
+	}
+	xdg_toplevel_set_title(client.windows[index].toplevel, title);
+	roundtrip();
+}
+
+void
+bench_client_main(int cmd_fd, int reply_fd)
+{
+	FILE *cmd = fdopen(cmd_fd, "r");
+	if (!cmd) {
+		die("fdopen");
+	}
+
+	char line[256];
+	while (fgets(line, sizeof(line), cmd)) {
+		line[strcspn(line, "\n")] = '\0';
+		char *arg = strchr(line, ' ');
+		if (arg) {
+			*arg++ = '\0';
+		}
+
+		if (!strcmp(line, "connect") && arg) {
+			client_connect(arg);
+		} else if (!strcmp(line, "map") && arg) {
+			map_windows(atoi(arg));
+		} else if (!strcmp(line, "bar")) {
+			bar_map();
+		} else if (!strcmp(line, "tick")) {
+			if (client.bar.surface) {
+				bar_draw();
+			}
+		} else if (!strcmp(line, "unmap")) {
+			unmap_windows();
+		} else if (!strcmp(line, "title") && arg) {
+			char *title = strchr(arg, ' ');
+			set_title(atoi(arg), title ? title + 1 : "");
+		} else if (!strcmp(line, "sync")) {
+			roundtrip();
+			roundtrip();
+		} else if (!strcmp(line, "quit")) {
+			break;
+		}
+
+		if (write(reply_fd, "ok\n", 3) != 3) {
+			die("write");
+		}
+	}
+
+	if (client.display) {
+		wl_display_disconnect(client.display);
+	}
+	_exit(EXIT_SUCCESS);
+}
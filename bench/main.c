@@ -0,0 +1,1110 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * labwc-bench - drive the compositor headlessly and report latencies
+ *
+ * The compositor is linked in as-is and runs on the headless backend with
+ * the pixman renderer. A number of synthetic xdg-shell clients are forked
+ * off and remote controlled over pipes, while keyboard and pointer input is
+ * injected through virtual wlr_keyboard/wlr_pointer devices. Each workload
+ * times individual operations and the output frames they trigger.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <linux/input-event-codes.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <wlr/interfaces/wlr_keyboard.h>
+#include <wlr/interfaces/wlr_pointer.h>
+#include "action.h"
+#include "bench.h"
+#include "common/font.h"
+#include "common/list.h"
+#include "common/macros.h"
+#include "common/mem.h"
+#include "common/spawn.h"
+#include "frame-stats.h"
+#include "labwc.h"
+#include "menu/menu.h"
+#include "theme.h"
+#include "view.h"
+#include "workspaces.h"
+
+/* Upper bound for waiting on output frames after an operation */
+#define FRAME_TIMEOUT_MS 40
+
+#define NR_DESKTOPS 4
+#define MOTION_STEPS 32
+
+/* Shape of the action chains run by the "actions" workload */
+#define ACTION_CHAIN_LEN 16
+#define ACTION_QUERIES 4
+#define ACTION_RUNS 64
+
+/* Bar redraws per round of the "layer" workload */
+#define BAR_TICKS 16
+
+/* Processes started per round of the "spawn" workload */
+#define SPAWN_RUNS 16
+#define SPAWN_REAP_TIMEOUT_MS 1000
+
+/* Shape of the generated menu.xml used by the "menu" workload */
+#define MENU_SUBMENUS 32
+#define MENU_ITEMS 32
+
+struct rcxml rc = { 0 };
+
+struct bench_client {
+	pid_t pid;
+	int cmd_fd;
+	int reply_fd;
+	struct wl_event_source *reply_source;
+	bool replied;
+};
+
+struct bench_output {
+	struct wlr_output *wlr_output;
+	uint64_t frame_start;
+	uint64_t frame_allocs;
+	unsigned int nr_frames;
+	struct wl_listener frame_begin;
+	struct wl_listener frame_end;
+	struct wl_listener destroy;
+	struct wl_list link; /* bench.outputs */
+};
+
+static struct {
+	struct server server;
+	struct theme theme;
+	struct bench_client *clients;
+	int nr_clients;
+	int nr_windows;
+	int nr_rounds;
+	struct wl_list outputs;
+	struct wl_listener new_output;
+	struct wlr_keyboard keyboard;
+	struct wlr_pointer pointer;
+	bool frames_timed_out;
+	struct configure_stats configure_stats;
+	char *tmp_config_dir;
+	char *tmp_runtime_dir;
+} bench;
+
+static const struct option long_options[] = {
+	{"clients", required_argument, NULL, 'c'},
+	{"config-dir", required_argument, NULL, 'C'},
+	{"debug", no_argument, NULL, 'd'},
+	{"help", no_argument, NULL, 'h'},
+	{"outputs", required_argument, NULL, 'o'},
+	{"rounds", required_argument, NULL, 'r'},
+	{"windows", required_argument, NULL, 'w'},
+	{0, 0, 0, 0}
+};
+
+static const char bench_usage[] =
+"Usage: labwc-bench [options...] [workload...]\n"
+"  -c, --clients <n>        Number of client processes (default 4)\n"
+"  -C, --config-dir <dir>   Specify config directory\n"
+"  -d, --debug              Enable full logging, including debug information\n"
+"  -h, --help               Show help message and quit\n"
+"  -o, --outputs <n>        Number of headless outputs (default 1)\n"
+"  -r, --rounds <n>         Number of rounds per workload (default 20)\n"
+"  -w, --windows <n>        Number of windows per client (default 8)\n"
+"Workloads: map cycle move resize workspace title reload actions layer\n"
+"           menu spawn (default all)\n";
+
+static void
+usage(void)
+{
+	printf("%s", bench_usage);
+	exit(0);
+}
+
+static void
+die(const char *msg)
+{
+	perror(msg);
+	exit(EXIT_FAILURE);
+}
+
+/* clients */
+
+static int
+handle_reply(int fd, uint32_t mask, void *data)
+{
+	struct bench_client *client = data;
+	char buf[16];
+	ssize_t len = read(fd, buf, sizeof(buf));
+	if (len <= 0) {
+		fprintf(stderr, "bench: client %d went away\n", client->pid);
+		exit(EXIT_FAILURE);
+	}
+	client->replied = true;
+	return 0;
+}
+
+static void
+set_cloexec(int fd)
+{
+	int flags = fcntl(fd, F_GETFD);
+	if (flags < 0 || fcntl(fd, F_SETFD, flags | FD_CLOEXEC) < 0) {
+		die("fcntl");
+	}
+}
+
+/*
+ * Clients are forked before the compositor is initialized so that they do
+ * not inherit any of its file descriptors.
+ */
+static void
+clients_spawn(void)
+{
+	bench.clients = znew_n(*bench.clients, bench.nr_clients);
+	for (int i = 0; i < bench.nr_clients; i++) {
+		struct bench_client *client = &bench.clients[i];
+		int cmd[2], reply[2];
+		if (pipe(cmd) < 0 || pipe(reply) < 0) {
+			die("pipe");
+		}
+		client->pid = fork();
+		if (client->pid < 0) {
+			die("fork");
+		} else if (client->pid == 0) {
+			close(cmd[1]);
+			close(reply[0]);
+			bench_client_main(cmd[0], reply[1]);
+		}
+		close(cmd[0]);
+		close(reply[1]);
+		set_cloexec(cmd[1]);
+		set_cloexec(reply[0]);
+		client->cmd_fd = cmd[1];
+		client->reply_fd = reply[0];
+		client->replied = true;
+	}
+}
+
+static void
+client_send(struct bench_client *client, const char *fmt, ...)
+{
+	char buf[256];
+	va_list ap;
+	va_start(ap, fmt);
+	int len = vsnprintf(buf, sizeof(buf) - 1, fmt, ap);
+	va_end(ap);
+	if (len < 0 || len >= (int)sizeof(buf) - 1) {
+		fprintf(stderr, "bench: command too long\n");
+		exit(EXIT_FAILURE);
+	}
+	buf[len++] = '\n';
+
+	assert(client->replied);
+	client->replied = false;
+	if (write(client->cmd_fd, buf, len) != len) {
+		die("write");
+	}
+}
+
+/* Run the compositor until every client has answered its last command */
+static void
+clients_wait(void)
+{
+	while (true) {
+		bool done = true;
+		for (int i = 0; i < bench.nr_clients; i++) {
+			done &= bench.clients[i].replied;
+		}
+		if (done) {
+			return;
+		}
+		wl_display_flush_clients(bench.server.wl_display);
+		if (wl_event_loop_dispatch(bench.server.wl_event_loop, -1) < 0) {
+			die("wl_event_loop_dispatch");
+		}
+	}
+}
+
+static void
+clients_send_all(const char *cmd)
+{
+	for (int i = 0; i < bench.nr_clients; i++) {
+		client_send(&bench.clients[i], "%s", cmd);
+	}
+	clients_wait();
+}
+
+static void
+clients_connect(const char *socket)
+{
+	for (int i = 0; i < bench.nr_clients; i++) {
+		struct bench_client *client = &bench.clients[i];
+		client->reply_source = wl_event_loop_add_fd(
+			bench.server.wl_event_loop, client->reply_fd,
+			WL_EVENT_READABLE, handle_reply, client);
+		client_send(client, "connect %s", socket);
+	}
+	clients_wait();
+}
+
+static void
+clients_finish(void)
+{
+	for (int i = 0; i < bench.nr_clients; i++) {
+		struct bench_client *client = &bench.clients[i];
+		wl_event_source_remove(client->reply_source);
+		if (write(client->cmd_fd, "quit\n", 5) != 5) {
+			die("write");
+		}
+		close(client->cmd_fd);
+	}
+	/* Keep the compositor alive while the clients disconnect */
+	for (int i = 0; i < bench.nr_clients; i++) {
+		struct bench_client *client = &bench.clients[i];
+		while (waitpid(client->pid, NULL, WNOHANG) == 0) {
+			wl_display_flush_clients(bench.server.wl_display);
+			wl_event_loop_dispatch(bench.server.wl_event_loop, 10);
+		}
+		close(client->reply_fd);
+	}
+	zfree(bench.clients);
+}
+
+static void
+map_all(void)
+{
+	char cmd[32];
+	snprintf(cmd, sizeof(cmd), "map %d", bench.nr_windows);
+	clients_send_all(cmd);
+}
+
+static void
+unmap_all(void)
+{
+	clients_send_all("unmap");
+}
+
+/* outputs */
+
+static void
+handle_frame_begin(struct wl_listener *listener, void *data)
+{
+	struct bench_output *output =
+		wl_container_of(listener, output, frame_begin);
+	output->frame_allocs = bench_alloc_count();
+	output->frame_start = bench_now();
+}
+
+static void
+handle_frame_end(struct wl_listener *listener, void *data)
+{
+	struct bench_output *output =
+		wl_container_of(listener, output, frame_end);
+	bench_stat_add(bench_stat_get("frame"), output->frame_start,
+		output->frame_allocs);
+	output->nr_frames++;
+}
+
+static void
+handle_output_destroy(struct wl_listener *listener, void *data)
+{
+	struct bench_output *output =
+		wl_container_of(listener, output, destroy);
+	wl_list_remove(&output->frame_begin.link);
+	wl_list_remove(&output->frame_end.link);
+	wl_list_remove(&output->destroy.link);
+	wl_list_remove(&output->link);
+	free(output);
+}
+
+/*
+ * This listener runs after the compositor's own new_output handler, so the
+ * frame_begin listener is put at the head of the signal's listener list to
+ * bracket output_frame_notify() with frame_begin and frame_end.
+ */
+static void
+handle_new_output(struct wl_listener *listener, void *data)
+{
+	struct wlr_output *wlr_output = data;
+	struct bench_output *output = znew(*output);
+	output->wlr_output = wlr_output;
+
+	output->frame_begin.notify = handle_frame_begin;
+	wl_list_insert(&wlr_output->events.frame.listener_list,
+		&output->frame_begin.link);
+	output->frame_end.notify = handle_frame_end;
+	wl_signal_add(&wlr_output->events.frame, &output->frame_end);
+	output->destroy.notify = handle_output_destroy;
+	wl_signal_add(&wlr_output->events.destroy, &output->destroy);
+
+	wl_list_append(&bench.outputs, &output->link);
+}
+
+static int
+handle_frames_timeout(void *data)
+{
+	bench.frames_timed_out = true;
+	return 0;
+}
+
+/*
+ * Let every output render the damage caused by the previous operation.
+ * Outputs without damage do not produce frames, hence the timeout.
+ */
+static void
+frames_wait(void)
+{
+	struct bench_output *output;
+	wl_list_for_each(output, &bench.outputs, link) {
+		output->nr_frames = 0;
+	}
+
+	bench.frames_timed_out = false;
+	struct wl_event_source *timer = wl_event_loop_add_timer(
+		bench.server.wl_event_loop, handle_frames_timeout, NULL);
+	wl_event_source_timer_update(timer, FRAME_TIMEOUT_MS);
+
+	while (!bench.frames_timed_out) {
+		bool done = true;
+		wl_list_for_each(output, &bench.outputs, link) {
+			done &= output->nr_frames > 0;
+		}
+		if (done) {
+			break;
+		}
+		wl_display_flush_clients(bench.server.wl_display);
+		wl_event_loop_dispatch(bench.server.wl_event_loop, -1);
+	}
+	wl_event_source_remove(timer);
+}
+
+/* input */
+
+static const struct wlr_keyboard_impl keyboard_impl = {
+	.name = "bench-keyboard",
+};
+
+static const struct wlr_pointer_impl pointer_impl = {
+	.name = "bench-pointer",
+};
+
+static uint32_t
+now_msec(void)
+{
+	return bench_now() / 1000000;
+}
+
+static void
+input_init(void)
+{
+	wlr_keyboard_init(&bench.keyboard, &keyboard_impl, "bench-keyboard");
+	wl_signal_emit_mutable(&bench.server.backend->events.new_input,
+		&bench.keyboard.base);
+	wlr_pointer_init(&bench.pointer, &pointer_impl, "bench-pointer");
+	wl_signal_emit_mutable(&bench.server.backend->events.new_input,
+		&bench.pointer.base);
+}
+
+static void
+input_finish(void)
+{
+	wlr_pointer_finish(&bench.pointer);
+	wlr_keyboard_finish(&bench.keyboard);
+}
+
+static void
+send_key(uint32_t keycode, enum wl_keyboard_key_state state)
+{
+	struct wlr_keyboard_key_event event = {
+		.time_msec = now_msec(),
+		.keycode = keycode,
+		.update_state = true,
+		.state = state,
+	};
+	wlr_keyboard_notify_key(&bench.keyboard, &event);
+}
+
+static void
+send_motion(double dx, double dy)
+{
+	struct wlr_pointer_motion_event event = {
+		.pointer = &bench.pointer,
+		.time_msec = now_msec(),
+		.delta_x = dx,
+		.delta_y = dy,
+		.unaccel_dx = dx,
+		.unaccel_dy = dy,
+	};
+	wl_signal_emit_mutable(&bench.pointer.events.motion, &event);
+	wl_signal_emit_mutable(&bench.pointer.events.frame, &bench.pointer);
+}
+
+static struct view *
+first_mapped_view(void)
+{
+	struct view *view;
+	wl_list_for_each(view, &bench.server.views, link) {
+		if (view->mapped) {
+			return view;
+		}
+	}
+	fprintf(stderr, "bench: no mapped view\n");
+	exit(EXIT_FAILURE);
+}
+
+static void
+warp_to_center(struct view *view)
+{
+	wlr_cursor_warp(bench.server.seat.cursor, NULL,
+		view->current.x + view->current.width / 2,
+		view->current.y + view->current.height / 2);
+}
+
+/* workloads */
+
+static void
+workload_map(void)
+{
+	struct bench_stat *map = bench_stat_get("map-storm");
+	struct bench_stat *unmap = bench_stat_get("unmap-storm");
+
+	for (int round = 0; round < bench.nr_rounds; round++) {
+		uint64_t allocs = bench_alloc_count();
+		uint64_t start = bench_now();
+		map_all();
+		bench_stat_add(map, start, allocs);
+		frames_wait();
+
+		allocs = bench_alloc_count();
+		start = bench_now();
+		unmap_all();
+		bench_stat_add(unmap, start, allocs);
+		frames_wait();
+	}
+}
+
+static void
+workload_cycle(void)
+{
+	struct bench_stat *cycle = bench_stat_get("cycle");
+	struct bench_stat *end = bench_stat_get("cycle-end");
+	int nr_views = bench.nr_clients * bench.nr_windows;
+
+	map_all();
+	for (int round = 0; round < bench.nr_rounds; round++) {
+		send_key(KEY_LEFTALT, WL_KEYBOARD_KEY_STATE_PRESSED);
+		for (int i = 0; i < nr_views; i++) {
+			uint64_t allocs = bench_alloc_count();
+			uint64_t start = bench_now();
+			send_key(KEY_TAB, WL_KEYBOARD_KEY_STATE_PRESSED);
+			send_key(KEY_TAB, WL_KEYBOARD_KEY_STATE_RELEASED);
+			bench_stat_add(cycle, start, allocs);
+			frames_wait();
+		}
+		uint64_t allocs = bench_alloc_count();
+		uint64_t start = bench_now();
+		send_key(KEY_LEFTALT, WL_KEYBOARD_KEY_STATE_RELEASED);
+		bench_stat_add(end, start, allocs);
+		frames_wait();
+	}
+	unmap_all();
+}
+
+/* Move back and forth so that the view never gets near an output edge */
+static double
+motion_delta(int step)
+{
+	return step < MOTION_STEPS / 2 ? 4 : -4;
+}
+
+static void
+workload_move(void)
+{
+	struct bench_stat *move = bench_stat_get("move");
+
+	map_all();
+	struct view *view = first_mapped_view();
+	for (int round = 0; round < bench.nr_rounds; round++) {
+		warp_to_center(view);
+		interactive_begin(view, LAB_INPUT_STATE_MOVE, 0);
+		for (int step = 0; step < MOTION_STEPS; step++) {
+			uint64_t allocs = bench_alloc_count();
+			uint64_t start = bench_now();
+			send_motion(motion_delta(step), motion_delta(step));
+			bench_stat_add(move, start, allocs);
+			frames_wait();
+		}
+		interactive_finish(view);
+	}
+	unmap_all();
+}
+
+/*
+ * A resize step is only complete once the client has acked the configure
+ * and committed a buffer of the new size, so include that round trip.
+ */
+static void
+workload_resize(void)
+{
+	struct bench_stat *resize = bench_stat_get("resize");
+
+	map_all();
+	struct view *view = first_mapped_view();
+	for (int round = 0; round < bench.nr_rounds; round++) {
+		wlr_cursor_warp(bench.server.seat.cursor, NULL,
+			view->current.x + view->current.width,
+			view->current.y + view->current.height);
+		interactive_begin(view, LAB_INPUT_STATE_RESIZE,
+			WLR_EDGE_RIGHT | WLR_EDGE_BOTTOM);
+		for (int step = 0; step < MOTION_STEPS; step++) {
+			uint64_t allocs = bench_alloc_count();
+			uint64_t start = bench_now();
+			send_motion(motion_delta(step), motion_delta(step));
+			clients_send_all("sync");
+			bench_stat_add(resize, start, allocs);
+			frames_wait();
+		}
+		interactive_finish(view);
+	}
+	bench.configure_stats = view->configure_stats;
+	unmap_all();
+}
+
+static void
+workload_workspace(void)
+{
+	struct bench_stat *stat = bench_stat_get("workspace-switch");
+	struct server *server = &bench.server;
+
+	map_all();
+
+	/* Spread the views evenly over all workspaces */
+	struct workspace *workspace = server->workspace_current;
+	struct view *view;
+	wl_list_for_each(view, &server->views, link) {
+		if (view->mapped) {
+			view_move_to_workspace(view, workspace);
+			workspace = workspaces_find(workspace, "right", true);
+		}
+	}
+
+	int nr_switches = bench.nr_rounds * wl_list_length(&server->workspaces);
+	for (int i = 0; i < nr_switches; i++) {
+		struct workspace *target = workspaces_find(
+			server->workspace_current, "right", true);
+		uint64_t allocs = bench_alloc_count();
+		uint64_t start = bench_now();
+		workspaces_switch_to(target, /* update_focus */ true);
+		bench_stat_add(stat, start, allocs);
+		frames_wait();
+	}
+	unmap_all();
+}
+
+static void
+workload_title(void)
+{
+	struct bench_stat *stat = bench_stat_get("title");
+
+	map_all();
+	for (int round = 0; round < bench.nr_rounds; round++) {
+		for (int i = 0; i < bench.nr_windows; i++) {
+			uint64_t allocs = bench_alloc_count();
+			uint64_t start = bench_now();
+			for (int j = 0; j < bench.nr_clients; j++) {
+				client_send(&bench.clients[j], "title %d %d-%d",
+					i, round, i);
+			}
+			clients_wait();
+			bench_stat_add(stat, start, allocs);
+			frames_wait();
+		}
+	}
+	unmap_all();
+}
+
+static void
+workload_reload(void)
+{
+	struct bench_stat *stat = bench_stat_get("reload");
+
+	map_all();
+	for (int round = 0; round < bench.nr_rounds; round++) {
+		uint64_t allocs = bench_alloc_count();
+		uint64_t start = bench_now();
+		/* SIGHUP is blocked and picked up by the event loop */
+		raise(SIGHUP);
+		wl_event_loop_dispatch(bench.server.wl_event_loop, -1);
+		bench_stat_add(stat, start, allocs);
+		frames_wait();
+	}
+	unmap_all();
+}
+
+static void
+add_query(struct wl_list *queries, const char *identifier, const char *title)
+{
+	struct view_query *query = znew(*query);
+	if (identifier) {
+		query->identifier = xstrdup(identifier);
+		glob_pattern_init(&query->identifier_glob, query->identifier);
+	}
+	if (title) {
+		query->title = xstrdup(title);
+		glob_pattern_init(&query->title_glob, query->title);
+	}
+	wl_list_append(queries, &query->link);
+}
+
+static void
+add_child_actions(struct action *parent, const char *branch)
+{
+	/* Toggled twice so that running the chain leaves views unchanged */
+	for (int i = 0; i < 2; i++) {
+		struct action *child = action_create("ToggleKeybinds");
+		wl_list_append(action_get_actionlist(parent, branch), &child->link);
+	}
+}
+
+/*
+ * Build a chain of If or ForEach actions, each with a number of queries
+ * of which only the last one can match the windows of the bench clients.
+ */
+static void
+build_action_chain(struct wl_list *actions, const char *name)
+{
+	wl_list_init(actions);
+	for (int i = 0; i < ACTION_CHAIN_LEN; i++) {
+		struct action *action = action_create(name);
+		struct wl_list *queries = action_get_querylist(action);
+		for (int j = 0; j < ACTION_QUERIES - 1; j++) {
+			char pattern[32];
+			snprintf(pattern, sizeof(pattern), "nomatch-%d-%d*", i, j);
+			add_query(queries, pattern, NULL);
+		}
+		add_query(queries, i % 2 ? "labwc-bench" : "nomatch",
+			"bench-*");
+		add_child_actions(action, "then");
+		add_child_actions(action, "else");
+		wl_list_append(actions, &action->link);
+	}
+}
+
+static void
+run_action_chain(struct bench_stat *stat, struct view *view,
+		struct wl_list *actions)
+{
+	for (int run = 0; run < ACTION_RUNS; run++) {
+		uint64_t allocs = bench_alloc_count();
+		uint64_t start = bench_now();
+		actions_run(view, &bench.server, actions, 0);
+		bench_stat_add(stat, start, allocs);
+	}
+}
+
+/*
+ * Dispatch overhead of keybind/mousebind actions, so no frames are
+ * waited for between runs.
+ */
+static void
+workload_actions(void)
+{
+	struct bench_stat *if_stat = bench_stat_get("actions-if");
+	struct bench_stat *for_each_stat = bench_stat_get("actions-foreach");
+
+	struct wl_list if_chain, for_each_chain;
+	build_action_chain(&if_chain, "If");
+	build_action_chain(&for_each_chain, "ForEach");
+
+	map_all();
+	struct view *view = first_mapped_view();
+	for (int round = 0; round < bench.nr_rounds; round++) {
+		run_action_chain(if_stat, view, &if_chain);
+		run_action_chain(for_each_stat, view, &for_each_chain);
+		frames_wait();
+	}
+	unmap_all();
+
+	action_list_free(&if_chain);
+	action_list_free(&for_each_chain);
+}
+
+/*
+ * A bar that redraws without changing its layer-surface state, while the
+ * windows of all clients are mapped on the same output(s).
+ */
+static void
+workload_layer(void)
+{
+	struct bench_stat *stat = bench_stat_get("layer-tick");
+	struct bench_client *client = &bench.clients[0];
+
+	map_all();
+	client_send(client, "bar");
+	clients_wait();
+	frames_wait();
+	for (int round = 0; round < bench.nr_rounds; round++) {
+		for (int i = 0; i < BAR_TICKS; i++) {
+			uint64_t allocs = bench_alloc_count();
+			uint64_t start = bench_now();
+			client_send(client, "tick");
+			clients_wait();
+			bench_stat_add(stat, start, allocs);
+		}
+		frames_wait();
+	}
+	unmap_all();
+}
+
+/*
+ * Rebuild the menus and open the root-menu plus each of its submenus, the
+ * first time after every rebuild and once more with everything in place.
+ */
+static void
+menu_open_all(struct bench_stat *stat)
+{
+	struct server *server = &bench.server;
+	struct menu *menu = menu_get_by_id(server, "root-menu");
+	if (!menu) {
+		return;
+	}
+	uint64_t allocs = bench_alloc_count();
+	uint64_t start = bench_now();
+	int nr_items = wl_list_length(&menu->menuitems);
+	menu_open(menu, 0, 0);
+	for (int i = 0; i < nr_items; i++) {
+		menu_item_select_next(server);
+	}
+	menu_close_root(server);
+	bench_stat_add(stat, start, allocs);
+	frames_wait();
+}
+
+static void
+workload_menu(void)
+{
+	struct bench_stat *reconfigure = bench_stat_get("menu-reconfigure");
+	struct bench_stat *open = bench_stat_get("menu-open-first");
+	struct bench_stat *reopen = bench_stat_get("menu-open-again");
+
+	for (int round = 0; round < bench.nr_rounds; round++) {
+		uint64_t allocs = bench_alloc_count();
+		uint64_t start = bench_now();
+		menu_reconfigure(&bench.server);
+		bench_stat_add(reconfigure, start, allocs);
+
+		menu_open_all(open);
+		menu_open_all(reopen);
+	}
+}
+
+/*
+ * Launch short-lived processes the way the Execute action does and let
+ * SIGCHLD reap them, timing both the launches and the reaping.
+ */
+static void
+workload_spawn(void)
+{
+	struct bench_stat *stat = bench_stat_get("spawn");
+	struct bench_stat *reap = bench_stat_get("spawn-reap");
+	/* Parsed once up front, like the command of an Execute action */
+	char **argv = spawn_parse_argv("true");
+
+	for (int round = 0; round < bench.nr_rounds; round++) {
+		for (int i = 0; i < SPAWN_RUNS; i++) {
+			uint64_t allocs = bench_alloc_count();
+			uint64_t start = bench_now();
+			spawn_async_argv(argv);
+			bench_stat_add(stat, start, allocs);
+		}
+
+		uint64_t allocs = bench_alloc_count();
+		uint64_t start = bench_now();
+		uint32_t deadline = now_msec() + SPAWN_REAP_TIMEOUT_MS;
+		struct spawn_stats stats;
+		spawn_get_stats(&stats);
+		while (stats.pending && now_msec() < deadline) {
+			wl_event_loop_dispatch(bench.server.wl_event_loop,
+				SPAWN_REAP_TIMEOUT_MS);
+			spawn_get_stats(&stats);
+		}
+		bench_stat_add(reap, start, allocs);
+	}
+	spawn_argv_free(argv);
+}
+
+static const struct workload {
+	const char *name;
+	void (*run)(void);
+} workloads[] = {
+	{ "map", workload_map },
+	{ "cycle", workload_cycle },
+	{ "move", workload_move },
+	{ "resize", workload_resize },
+	{ "workspace", workload_workspace },
+	{ "title", workload_title },
+	{ "reload", workload_reload },
+	{ "actions", workload_actions },
+	{ "layer", workload_layer },
+	{ "menu", workload_menu },
+	{ "spawn", workload_spawn },
+};
+
+static const struct workload *
+workload_find(const char *name)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(workloads); i++) {
+		if (!strcmp(workloads[i].name, name)) {
+			return &workloads[i];
+		}
+	}
+	fprintf(stderr, "bench: unknown workload '%s'\n", name);
+	exit(EXIT_FAILURE);
+}
+
+/* environment */
+
+static char *
+make_tmp_dir(void)
+{
+	char *dir = xstrdup("/tmp/labwc-bench-XXXXXX");
+	if (!mkdtemp(dir)) {
+		die("mkdtemp");
+	}
+	return dir;
+}
+
+static void
+write_config(const char *dir)
+{
+	char path[256];
+	snprintf(path, sizeof(path), "%s/rc.xml", dir);
+	FILE *f = fopen(path, "w");
+	if (!f) {
+		die("fopen");
+	}
+	fprintf(f, "<labwc_config>\n"
+		"  <desktops number=\"%d\" popupTime=\"0\" />\n"
+		"</labwc_config>\n", NR_DESKTOPS);
+	fclose(f);
+
+	snprintf(path, sizeof(path), "%s/menu.xml", dir);
+	f = fopen(path, "w");
+	if (!f) {
+		die("fopen");
+	}
+	fprintf(f, "<openbox_menu>\n<menu id=\"root-menu\">\n");
+	for (int i = 0; i < MENU_SUBMENUS; i++) {
+		fprintf(f, "<menu id=\"bench-%d\" label=\"Submenu %d\">\n",
+			i, i);
+		for (int j = 0; j < MENU_ITEMS; j++) {
+			fprintf(f, "<item label=\"Item %d.%d\">"
+				"<action name=\"Execute\" command=\"true\" />"
+				"</item>\n", i, j);
+		}
+		fprintf(f, "</menu>\n");
+	}
+	fprintf(f, "</menu>\n</openbox_menu>\n");
+	fclose(f);
+}
+
+static void
+remove_tmp_dir(char *dir, const char *const *files)
+{
+	if (!dir) {
+		return;
+	}
+	for (; files && *files; files++) {
+		char path[256];
+		snprintf(path, sizeof(path), "%s/%s", dir, *files);
+		unlink(path);
+	}
+	rmdir(dir);
+	free(dir);
+}
+
+static void
+environment_init(int nr_outputs)
+{
+	char outputs[16];
+	snprintf(outputs, sizeof(outputs), "%d", nr_outputs);
+	setenv("WLR_BACKENDS", "headless", true);
+	setenv("WLR_RENDERER", "pixman", true);
+	setenv("WLR_HEADLESS_OUTPUTS", outputs, true);
+	setenv("WLR_LIBINPUT_NO_DEVICES", "1", true);
+	unsetenv("WAYLAND_DISPLAY");
+	unsetenv("DISPLAY");
+
+	if (!getenv("XDG_RUNTIME_DIR")) {
+		bench.tmp_runtime_dir = make_tmp_dir();
+		setenv("XDG_RUNTIME_DIR", bench.tmp_runtime_dir, true);
+	}
+
+	if (!rc.config_dir) {
+		bench.tmp_config_dir = make_tmp_dir();
+		write_config(bench.tmp_config_dir);
+		rc.config_dir = xstrdup(bench.tmp_config_dir);
+	}
+}
+
+int
+main(int argc, char *argv[])
+{
+	enum wlr_log_importance verbosity = WLR_ERROR;
+	int nr_outputs = 1;
+	bench.nr_clients = 4;
+	bench.nr_windows = 8;
+	bench.nr_rounds = 20;
+
+	int c;
+	while (1) {
+		int index = 0;
+		c = getopt_long(argc, argv, "c:C:dho:r:w:", long_options, &index);
+		if (c == -1) {
+			break;
+		}
+		switch (c) {
+		case 'c':
+			bench.nr_clients = atoi(optarg);
+			break;
+		case 'C':
+			rc.config_dir = xstrdup(optarg);
+			break;
+		case 'd':
+			verbosity = WLR_DEBUG;
+			break;
+		case 'o':
+			nr_outputs = atoi(optarg);
+			break;
+		case 'r':
+			bench.nr_rounds = atoi(optarg);
+			break;
+		case 'w':
+			bench.nr_windows = atoi(optarg);
+			break;
+		case 'h':
+		default:
+			usage();
+		}
+	}
+	if (bench.nr_clients < 1 || bench.nr_windows < 1
+			|| bench.nr_rounds < 1 || nr_outputs < 1) {
+		usage();
+	}
+	/* Validate workload names before anything is spawned */
+	for (int i = optind; i < argc; i++) {
+		workload_find(argv[i]);
+	}
+
+	wlr_log_init(verbosity, NULL);
+	environment_init(nr_outputs);
+	clients_spawn();
+
+	rcxml_read(NULL);
+
+	wl_list_init(&bench.outputs);
+	struct server *server = &bench.server;
+	server_init(server);
+	bench.new_output.notify = handle_new_output;
+	wl_signal_add(&server->backend->events.new_output, &bench.new_output);
+	server_start(server);
+
+	theme_init(&bench.theme, rc.theme_name);
+	rc.theme = &bench.theme;
+	server->theme = &bench.theme;
+
+	menu_init(server);
+	input_init();
+	clients_connect(getenv("WAYLAND_DISPLAY"));
+
+	if (optind < argc) {
+		for (int i = optind; i < argc; i++) {
+			workload_find(argv[i])->run();
+		}
+	} else {
+		for (size_t i = 0; i < ARRAY_SIZE(workloads); i++) {
+			workloads[i].run();
+		}
+	}
+
+	printf("labwc-bench: %d clients x %d windows, %d rounds, %d outputs\n",
+		bench.nr_clients, bench.nr_windows, bench.nr_rounds,
+		nr_outputs);
+	bench_stats_print();
+
+	struct font_cache_stats font_stats;
+	font_cache_get_stats(&font_stats);
+	printf("font cache: %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64
+		" evictions, %d entries\n", font_stats.hits, font_stats.misses,
+		font_stats.evictions, font_stats.entries);
+	struct theme_cache_stats theme_stats;
+	theme_cache_get_stats(&theme_stats);
+	printf("theme asset cache: %" PRIu64 " hits, %" PRIu64 " misses, %"
+		PRIu64 " evictions, %" PRIu64 " scaled renders, %d entries\n",
+		theme_stats.hits, theme_stats.misses, theme_stats.evictions,
+		theme_stats.scaled, theme_stats.entries);
+	struct spawn_stats spawn_stats;
+	spawn_get_stats(&spawn_stats);
+	printf("processes: %" PRIu64 " spawned, %" PRIu64 " reaped, %d pending\n",
+		spawn_stats.spawned, spawn_stats.reaped, spawn_stats.pending);
+	printf("pointer motion: %" PRIu64 " events received, %" PRIu64
+		" processed\n", server->seat.motion.received,
+		server->seat.motion.processed);
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		if (!output->layer_stats.commits) {
+			continue;
+		}
+		printf("layer-shell on %s: %" PRIu64 " commits, %" PRIu64
+			" layer arrangements, %" PRIu64 " view arrangements\n",
+			output->wlr_output->name, output->layer_stats.commits,
+			output->layer_stats.layer_arranges,
+			output->layer_stats.view_arranges);
+	}
+	wl_list_for_each(output, &server->outputs, link) {
+		struct frame_stats *stats = &output->frame_stats;
+		struct frame_summary summary;
+		frame_stats_summarize(stats, &summary);
+		printf("frames on %s: %" PRIu64 " commits, %" PRIu64 " skipped, %"
+			PRIu64 " failed, commit p50 %u us, p99 %u us, damage"
+			" p50 %u.%u%%, p99 %u.%u%%, %" PRIu64 " full repaints\n",
+			output->wlr_output->name, stats->commits, stats->skipped,
+			stats->failures, summary.commit_usec_p50,
+			summary.commit_usec_p99,
+			summary.damage_permille_p50 / 10,
+			summary.damage_permille_p50 % 10,
+			summary.damage_permille_p99 / 10,
+			summary.damage_permille_p99 % 10, stats->full_damage);
+	}
+	struct configure_stats *configure = &bench.configure_stats;
+	if (configure->count) {
+		printf("resize configure round-trip: %" PRIu64 " acked, %" PRIu64
+			" timed out, avg %" PRIu64 " us, max %" PRIu64 " us\n",
+			configure->count, configure->timeouts,
+			configure->total_usec / configure->count,
+			configure->max_usec);
+	}
+
+	clients_finish();
+	input_finish();
+	wl_list_remove(&bench.new_output.link);
+	server_finish(server);
+
+	menu_finish(server);
+	theme_finish(&bench.theme);
+	theme_cache_finish();
+	menu_pipe_cache_finish();
+	rcxml_finish();
+	font_finish();
+	bench_stats_finish();
+
+	static const char *const config_files[] = { "rc.xml", "menu.xml", NULL };
+	remove_tmp_dir(bench.tmp_config_dir, config_files);
+	remove_tmp_dir(bench.tmp_runtime_dir, NULL);
+	return 0;
+}
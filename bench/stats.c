@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+#include "common/list.h"
+#include "common/mem.h"
+
+static struct wl_list stats;
+
+uint64_t
+bench_now(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+struct bench_stat *
+bench_stat_get(const char *name)
+{
+	if (!stats.next) {
+		wl_list_init(&stats);
+	}
+
+	struct bench_stat *stat;
+	wl_list_for_each(stat, &stats, link) {
+		if (!strcmp(stat->name, name)) {
+			return stat;
+		}
+	}
+	stat = znew(*stat);
+	stat->name = name;
+	wl_array_init(&stat->samples);
+	wl_list_append(&stats, &stat->link);
+	return stat;
+}
+
+void
+bench_stat_add(struct bench_stat *stat, uint64_t start_ns,
+		uint64_t start_allocs)
+{
+	/* Read the counters before wl_array_add() can allocate */
+	uint64_t allocs = bench_alloc_count() - start_allocs;
+	uint64_t elapsed = bench_now() - start_ns;
+
+	stat->allocs += allocs;
+	uint64_t *sample = wl_array_add(&stat->samples, sizeof(*sample));
+	if (!sample) {
+		fprintf(stderr, "bench: cannot store sample\n");
+		exit(EXIT_FAILURE);
+	}
+	*sample = elapsed;
+}
+
+static int
+compare_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of sorted samples, in microseconds */
+static double
+percentile(uint64_t *sorted, size_t count, unsigned int p)
+{
+	size_t rank = (count * p + 99) / 100;
+	if (rank < 1) {
+		rank = 1;
+	}
+	return sorted[rank - 1] / 1000.0;
+}
+
+void
+bench_stats_print(void)
+{
+	if (!stats.next) {
+		return;
+	}
+
+	printf("%-24s %8s %10s %10s %10s %10s %10s\n", "metric", "count",
+		"p50 (us)", "p90 (us)", "p99 (us)", "max (us)", "allocs/op");
+
+	struct bench_stat *stat;
+	wl_list_for_each(stat, &stats, link) {
+		size_t count = stat->samples.size / sizeof(uint64_t);
+		if (!count) {
+			continue;
+		}
+		uint64_t *samples = stat->samples.data;
+		qsort(samples, count, sizeof(*samples), compare_u64);
+		printf("%-24s %8zu %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+			stat->name, count,
+			percentile(samples, count, 50),
+			percentile(samples, count, 90),
+			percentile(samples, count, 99),
+			samples[count - 1] / 1000.0,
+			(double)stat->allocs / count);
+	}
+}
+
+void
+bench_stats_finish(void)
+{
+	if (!stats.next) {
+		return;
+	}
+
+	struct bench_stat *stat, *tmp;
+	wl_list_for_each_safe(stat, tmp, &stats, link) {
+		wl_list_remove(&stat->link);
+		wl_array_release(&stat->samples);
+		free(stat);
+	}
+}
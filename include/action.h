@@ -2,6 +2,8 @@
 #ifndef LABWC_ACTION_H
 #define LABWC_ACTION_H
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <wayland-util.h>
 
 struct view;
@@ -15,19 +17,67 @@ struct action {
 			      */
 
 	uint32_t type;        /* enum action_type */
-	struct wl_list args;  /* struct action_arg.link */
+
+	/*
+	 * Arguments are resolved while parsing so that running an action
+	 * does not involve any lookups or allocations. Which member is
+	 * used depends on @type.
+	 */
+	union {
+		/* Execute */
+		struct {
+			char **argv; /* tilde expanded and split, NULL-terminated */
+		} execute;
+		/* MoveToEdge, SnapToEdge, GrowToEdge, ShrinkToEdge */
+		struct {
+			int direction; /* enum view_edge */
+			bool snap_windows;
+		} edge;
+		/* ToggleMaximize, Maximize */
+		struct {
+			int direction; /* enum view_axis */
+		} maximize;
+		/* ResizeRelative */
+		struct {
+			int left, right, top, bottom;
+		} resize_relative;
+		/* MoveTo, MoveRelative */
+		struct {
+			int x, y;
+		} move;
+		/* ResizeTo */
+		struct {
+			int width, height;
+		} resize_to;
+		/* GoToDesktop, SendToDesktop */
+		struct {
+			char *to;
+			bool follow;
+			bool wrap;
+		} desktop;
+		/* ShowMenu, SnapToRegion, FocusOutput, VirtualOutput{Add,Remove} */
+		struct {
+			char *name;
+		} target;
+		/* If, ForEach */
+		struct {
+			struct wl_list queries;   /* struct view_query.link */
+			struct wl_list then;      /* struct action.link */
+			struct wl_list otherwise; /* struct action.link */
+		} cond;
+	} args;
 };
 
 struct action *action_create(const char *action_name);
 
 bool action_is_valid(struct action *action);
 
-void action_arg_add_str(struct action *action, const char *key, const char *value);
-void action_arg_add_actionlist(struct action *action, const char *key);
-void action_arg_add_querylist(struct action *action, const char *key);
-
-struct wl_list *action_get_actionlist(struct action *action, const char *key);
-struct wl_list *action_get_querylist(struct action *action, const char *key);
+/*
+ * Only If and ForEach actions have query and action lists, NULL is
+ * returned for any other action type. Branches are "then" and "else".
+ */
+struct wl_list *action_get_actionlist(struct action *action, const char *branch);
+struct wl_list *action_get_querylist(struct action *action);
 
 void action_arg_from_xml_node(struct action *action, const char *nodename, const char *content);
 
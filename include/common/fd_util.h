@@ -2,7 +2,15 @@
 #ifndef LABWC_FD_UTIL_H
 #define LABWC_FD_UTIL_H
 
+#include <stdbool.h>
+#include <sys/types.h>
+
 void increase_nofile_limit(void);
-void restore_nofile_limit(void);
+/* Returns true if the limit had been increased and was lowered again */
+bool restore_nofile_limit(void);
+#ifdef __linux__
+/* Lowers the limit of another process, e.g. a freshly spawned child */
+bool restore_nofile_limit_of(pid_t pid);
+#endif
 
 #endif /* LABWC_FD_UTIL_H */
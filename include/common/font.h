@@ -1,6 +1,7 @@
 /* SPDX-License-Identifier: GPL-2.0-only */
 #ifndef LABWC_FONT_H
 #define LABWC_FONT_H
+#include <stdint.h>
 
 struct lab_data_buffer;
 
@@ -49,7 +50,29 @@ void font_buffer_create(struct lab_data_buffer **buffer, int max_width,
 	double scale);
 
 /**
- * font_finish - free some font related resources
+ * struct font_cache_stats - counters of the text measurement cache
+ * @hits: lookups answered from the cache
+ * @misses: lookups which required pango to shape the text
+ * @evictions: entries dropped because the cache was full
+ * @entries: number of entries currently cached
+ */
+struct font_cache_stats {
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+	int entries;
+};
+
+/**
+ * font_cache_get_stats - get counters of the text measurement cache
+ * used by font_height(), font_width() and font_buffer_create()
+ * @stats: filled with the current counter values
+ */
+void font_cache_get_stats(struct font_cache_stats *stats);
+
+/**
+ * font_finish - free font related resources including the text
+ * measurement cache
  * Note: use on exit
  */
 void font_finish(void);
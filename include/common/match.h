@@ -3,6 +3,7 @@
 #define LABWC_MATCH_H
 
 #include <stdbool.h>
+#include <stddef.h>
 
 /**
  * match_glob() - Pattern match using '*' wildcards and '?' jokers.
@@ -12,4 +13,38 @@
  */
 bool match_glob(const char *pattern, const char *string);
 
+enum glob_pattern_type {
+	LAB_GLOB_FNMATCH = 0,
+	LAB_GLOB_ANY,
+	LAB_GLOB_LITERAL,
+	LAB_GLOB_PREFIX,
+};
+
+/**
+ * struct glob_pattern - glob pattern analysed for cheaper matching
+ * @type: how glob_pattern_match() compares strings
+ * @pattern: pattern string, not owned by this struct
+ * @len: length of the literal part of @pattern
+ */
+struct glob_pattern {
+	enum glob_pattern_type type;
+	const char *pattern;
+	size_t len;
+};
+
+/**
+ * glob_pattern_init() - Analyse pattern so that plain strings, '*' and
+ * 'prefix*' can be matched without going through fnmatch().
+ * @glob: Compiled pattern to initialize.
+ * @pattern: Pattern which must outlive @glob.
+ */
+void glob_pattern_init(struct glob_pattern *glob, const char *pattern);
+
+/**
+ * glob_pattern_match() - Same as match_glob() for a compiled pattern.
+ * @glob: Pattern initialized by glob_pattern_init().
+ * @string: String to search.
+ */
+bool glob_pattern_match(const struct glob_pattern *glob, const char *string);
+
 #endif /* LABWC_MATCH_H */
@@ -2,10 +2,83 @@
 #ifndef LABWC_SPAWN_H
 #define LABWC_SPAWN_H
 
+#include <stdint.h>
+#include <sys/types.h>
+
+/**
+ * struct spawn_stats - counters for processes started by labwc
+ * @spawned: number of children started
+ * @reaped: number of children waited for after they exited
+ * @pending: number of children still waiting to be reaped
+ */
+struct spawn_stats {
+	uint64_t spawned;
+	uint64_t reaped;
+	int pending;
+};
+
 /**
  * spawn_async_no_shell - execute asyncronously
  * @command: command to be executed
  */
 void spawn_async_no_shell(char const *command);
 
+/**
+ * spawn_parse_argv - split command into arguments like a shell would
+ * @command: command to be split
+ * Returns a NULL-terminated array to be freed with spawn_argv_free(),
+ * or NULL if @command could not be parsed.
+ */
+char **spawn_parse_argv(const char *command);
+
+/**
+ * spawn_argv_free - free arguments returned by spawn_parse_argv()
+ * @argv: arguments to be freed, may be NULL
+ */
+void spawn_argv_free(char **argv);
+
+/**
+ * spawn_async_argv - execute asyncronously
+ * @argv: arguments as returned by spawn_parse_argv()
+ *
+ * The child is reaped by spawn_reap_children() once it has exited.
+ */
+void spawn_async_argv(char **argv);
+
+/**
+ * spawn_piped - execute asyncronously with stdout connected to a pipe
+ * @command: command to be executed, split like spawn_parse_argv() does
+ * @pipe_fd: set to the non-blocking, close-on-exec read end of the pipe
+ *
+ * Unlike spawn_async_argv() the child is not reaped automatically, so the
+ * caller can still signal it. Once done with it, the caller hands it over
+ * with spawn_reap_async() and is responsible for closing @pipe_fd.
+ * Returns the pid of the child or -1 on failure.
+ */
+pid_t spawn_piped(const char *command, int *pipe_fd);
+
+/**
+ * spawn_reap_async - reap a child once it has exited
+ * @pid: child as returned by spawn_piped()
+ */
+void spawn_reap_async(pid_t pid);
+
+/**
+ * spawn_reap_children - reap all exited children, to be called on SIGCHLD
+ *
+ * Only children started by the functions above are waited for.
+ */
+void spawn_reap_children(void);
+
+/**
+ * spawn_get_stats - get the counters of processes started by labwc
+ * @stats: filled in with the current counters
+ */
+void spawn_get_stats(struct spawn_stats *stats);
+
+/**
+ * spawn_finish - stop tracking children, those still running are left alone
+ */
+void spawn_finish(void);
+
 #endif /* LABWC_SPAWN_H */
@@ -37,5 +37,33 @@ uint32_t parse_modifier(const char *symname);
 
 bool keybind_the_same(struct keybind *a, struct keybind *b);
 
+/**
+ * keybind_update_keycodes - resolve the keycodes of all keybinds for the
+ * current keymap and rebuild the lookup index used by keybind_find_by_*()
+ * @server: server whose keyboard group provides the keymap
+ *
+ * Must be called whenever rc.keybinds or the keymap changes.
+ */
 void keybind_update_keycodes(struct server *server);
+
+/**
+ * keybind_find_by_keycode - find the first keybind bound to a keycode
+ * @modifiers: modifiers which must match exactly
+ * @keycode: xkb keycode
+ * @toggle_only: only consider keybinds containing a ToggleKeybinds action
+ */
+struct keybind *keybind_find_by_keycode(uint32_t modifiers,
+	xkb_keycode_t keycode, bool toggle_only);
+
+/**
+ * keybind_find_by_sym - find the first keybind bound to a keysym
+ * @modifiers: modifiers which must match exactly
+ * @sym: keysym, matched case-insensitively
+ * @toggle_only: only consider keybinds containing a ToggleKeybinds action
+ */
+struct keybind *keybind_find_by_sym(uint32_t modifiers, xkb_keysym_t sym,
+	bool toggle_only);
+
+/* Drop the lookup index, to be called before rc.keybinds is freed */
+void keybind_index_finish(void);
 #endif /* LABWC_KEYBIND_H */
@@ -2,6 +2,8 @@
 #ifndef LABWC_MOUSEBIND_H
 #define LABWC_MOUSEBIND_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include <wayland-util.h>
 #include "ssd.h"
 #include "config/keybind.h"
@@ -42,6 +44,17 @@ struct mousebind {
 
 	struct wl_list link;     /* struct rcxml.mousebinds */
 	bool pressed_in_context; /* used in click events */
+	struct wl_list pressed_link; /* see mousebind_set_pressed() */
+};
+
+/**
+ * struct mousebind_match - mousebinds sharing button/direction and modifiers
+ * @mousebinds: array of @count matching mousebinds in rc.xml order
+ * @count: number of entries in @mousebinds
+ */
+struct mousebind_match {
+	struct mousebind **mousebinds;
+	size_t count;
 };
 
 enum mouse_event mousebind_event_from_str(const char *str);
@@ -50,4 +63,40 @@ enum direction mousebind_direction_from_str(const char *str, uint32_t *modifiers
 struct mousebind *mousebind_create(const char *context);
 bool mousebind_the_same(struct mousebind *a, struct mousebind *b);
 
+/**
+ * mousebind_index_build - index rc.mousebinds for lookups by button or
+ * scroll direction and modifiers. Called after rc.xml has been read.
+ */
+void mousebind_index_build(void);
+void mousebind_index_finish(void);
+
+/**
+ * mousebind_find_by_button - get non-scroll mousebinds for a button
+ * @modifiers: currently pressed modifiers
+ * @button: ex: BTN_LEFT
+ * The context still has to be checked by the caller.
+ */
+struct mousebind_match mousebind_find_by_button(uint32_t modifiers,
+	uint32_t button);
+
+/**
+ * mousebind_find_by_direction - get scroll mousebinds for a direction
+ * @modifiers: currently pressed modifiers
+ * @direction: scroll direction
+ * The context still has to be checked by the caller.
+ */
+struct mousebind_match mousebind_find_by_direction(uint32_t modifiers,
+	enum direction direction);
+
+/*
+ * Click and drag mousebinds are armed on button press and processed on
+ * release or motion respectively. Armed mousebinds are kept in a list so
+ * that pointer motion does not need to look at any other mousebind.
+ */
+void mousebind_set_pressed(struct mousebind *mousebind);
+/* Disarm all mousebinds of @button */
+void mousebind_clear_pressed(uint32_t button);
+/* Disarm and return the first armed drag mousebind, or NULL if none */
+struct mousebind *mousebind_take_pressed_drag(void);
+
 #endif /* LABWC_MOUSEBIND_H */
@@ -20,6 +20,19 @@ enum window_switcher_field_content {
 	LAB_FIELD_TITLE,
 };
 
+/*
+ * Top-level rc.xml sections whose contents are compared on reconfigure so
+ * that only the affected subsystems are re-applied
+ */
+enum rc_section {
+	RC_SECTION_KEYBOARD = 0,
+	RC_SECTION_WINDOW_RULES,
+	RC_SECTION_LIBINPUT,
+	RC_SECTION_THEME,
+	RC_SECTION_REGIONS,
+	RC_SECTION_COUNT
+};
+
 struct usable_area_override {
 	struct border margin;
 	char *output;
@@ -40,6 +53,7 @@ struct rcxml {
 	int gap;
 	bool adaptive_sync;
 	bool reuse_output_mode;
+	int title_update_interval; /* ms */
 
 	/* focus */
 	bool focus_follow_mouse;
@@ -71,12 +85,14 @@ struct rcxml {
 	long doubleclick_time;     /* in ms */
 	struct wl_list mousebinds; /* struct mousebind.link */
 	double scroll_factor;
+	bool coalesce_motion;
 
 	/* libinput */
 	struct wl_list libinput_categories;
 
 	/* resistance */
 	int screen_edge_strength;
+	int window_edge_strength;
 
 	/* window snapping */
 	int snap_edge_range;
@@ -84,6 +100,10 @@ struct rcxml {
 
 	enum resize_indicator_mode resize_indicator;
 
+	/* menu */
+	int menu_release_timeout; /* ms, 0 keeps menus instantiated */
+	int menu_pipemenu_cache_time; /* ms, 0 re-runs generators each time */
+
 	struct {
 		int popuptime;
 		int min_nr_workspaces;
@@ -101,6 +121,9 @@ struct rcxml {
 	} window_switcher;
 
 	struct wl_list window_rules; /* struct window_rule.link */
+
+	/* Hash of each section as written in rc.xml, 0 if absent */
+	uint64_t section_digest[RC_SECTION_COUNT];
 };
 
 extern struct rcxml rc;
@@ -0,0 +1,96 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_FRAME_STATS_H
+#define LABWC_FRAME_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct output;
+struct scaled_font_buffer;
+struct server;
+struct wlr_scene_output;
+struct wlr_scene_rect;
+struct wlr_scene_tree;
+
+/* Number of most recent commits the histograms are built from */
+#define FRAME_STATS_WINDOW 512
+
+#define FRAME_STATS_OVERLAY_LINES 3
+
+struct frame_sample {
+	uint32_t commit_usec;
+	uint16_t damage_permille; /* share of the output that was repainted */
+};
+
+struct frame_stats {
+	/* Totals since the output was created */
+	uint64_t commits;
+	uint64_t skipped;       /* frame events with nothing to repaint */
+	uint64_t gamma_commits;
+	uint64_t failures;      /* commits rejected by the backend */
+	uint64_t full_damage;   /* commits which repainted the whole output */
+
+	/* Ring of the most recent commits, the next slot is commits % WINDOW */
+	struct frame_sample samples[FRAME_STATS_WINDOW];
+
+	struct {
+		struct wlr_scene_tree *tree;
+		struct wlr_scene_rect *background;
+		struct scaled_font_buffer *lines[FRAME_STATS_OVERLAY_LINES];
+		uint64_t updated_msec;
+		uint64_t updated_commits;
+	} overlay;
+};
+
+/* Percentiles over the commits in the window */
+struct frame_summary {
+	uint32_t nr_samples;
+	uint32_t commit_usec_p50;
+	uint32_t commit_usec_p99;
+	uint32_t commit_usec_max;
+	uint16_t damage_permille_p50;
+	uint16_t damage_permille_p99;
+	uint32_t full_damage; /* commits in the window that repainted everything */
+};
+
+uint64_t frame_stats_now(void);
+
+/**
+ * frame_stats_damage - damaged share of an output in permille
+ * @scene_output: output about to be committed
+ *
+ * Must be called before wlr_scene_output_commit() which consumes the
+ * pending damage.
+ */
+int frame_stats_damage(struct wlr_scene_output *scene_output);
+
+/**
+ * frame_stats_add - record a scene output commit
+ * @commit_nsec: time spent in wlr_scene_output_commit()
+ * @damage_permille: value returned by frame_stats_damage()
+ * @success: whether the backend accepted the commit
+ */
+void frame_stats_add(struct frame_stats *stats, uint64_t commit_nsec,
+	int damage_permille, bool success);
+
+void frame_stats_summarize(struct frame_stats *stats,
+	struct frame_summary *summary);
+
+/**
+ * frame_stats_dump - print commit time and damage histograms of all outputs
+ * to stdout
+ */
+void frame_stats_dump(struct server *server);
+
+/**
+ * frame_stats_overlay_toggle - show or hide the frame statistics in the
+ * top-left corner of every output
+ */
+void frame_stats_overlay_toggle(struct server *server);
+
+/* Refresh the overlay of @output, rate limited to twice per second */
+void frame_stats_overlay_update(struct output *output);
+
+void frame_stats_overlay_destroy(struct output *output);
+
+#endif /* LABWC_FRAME_STATS_H */
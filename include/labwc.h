@@ -42,6 +42,7 @@
 #include <wlr/util/log.h>
 #include "config/keybind.h"
 #include "config/rcxml.h"
+#include "frame-stats.h"
 #include "input/cursor.h"
 #include "regions.h"
 #include "session-lock.h"
@@ -160,6 +161,20 @@ struct seat {
 	struct wl_listener new_input;
 	struct wl_listener focus_change;
 
+	/* Pointer motion coalescing, see <mouse><coalesceMotion> */
+	struct {
+		bool pending;
+		uint32_t time_msec;
+		struct wl_event_source *idle;
+		/* Surface with pointer focus and its layout coordinates */
+		struct wlr_surface *surface;
+		double surface_lx, surface_ly;
+		struct wl_listener surface_destroy;
+		/* Motion events received vs. processed by the compositor */
+		uint64_t received;
+		uint64_t processed;
+	} motion;
+
 	struct wl_listener cursor_motion;
 	struct wl_listener cursor_motion_absolute;
 	struct wl_listener cursor_button;
@@ -221,6 +236,10 @@ struct server {
 	struct wlr_xwayland *xwayland;
 	struct wl_listener xwayland_ready;
 	struct wl_listener xwayland_new_surface;
+
+	/* Mapped views with _NET_WM_STRUT_PARTIAL */
+	struct wl_list strut_views; /* struct xwayland_view.strut_link */
+	uint32_t strut_serial; /* bumped when any strut changes */
 #endif
 
 	struct wlr_input_inhibit_manager *input_inhibit;
@@ -231,6 +250,8 @@ struct server {
 	struct wl_listener xdg_activation_request;
 
 	struct wl_list views;
+	struct wl_list views_always_on_top; /* struct view.workspace_link */
+	struct wl_list views_omnipresent; /* struct view.omnipresent_link */
 	struct wl_list unmanaged_surfaces;
 
 	struct seat seat;
@@ -325,6 +346,8 @@ struct server {
 		struct wlr_scene_node *preview_node;
 		struct wlr_scene_node *preview_anchor;
 		struct multi_rect *preview_outline;
+		struct wl_array rows; /* struct osd_row *, see osd.c */
+		struct wl_event_source *update_idle;
 	} osd_state;
 
 	struct theme *theme;
@@ -347,9 +370,39 @@ struct output {
 	struct wlr_scene_buffer *workspace_osd;
 	struct wlr_box usable_area;
 
+#if HAVE_XWAYLAND
+	/*
+	 * Inputs and result of the last strut adjustment, so that layer
+	 * commits which leave the exclusive zones alone skip the walk
+	 */
+	struct {
+		struct wlr_box layers_area;
+		struct wlr_box usable_area;
+		uint32_t strut_serial;
+		bool valid;
+	} strut_cache;
+#endif
+
 	struct wl_list regions;  /* struct region.link */
+	struct wl_list views;    /* struct view.output_link */
+
+	/* Layer-shell commits and the re-arrangements they caused */
+	struct {
+		uint64_t commits;
+		uint64_t layer_arranges;
+		uint64_t view_arranges;
+	} layer_stats;
 
-	struct lab_data_buffer *osd_buffer;
+	/* Commit times and damage, see frame-stats.h */
+	struct frame_stats frame_stats;
+
+	/* Window switcher, rebuilt only when its rows change */
+	struct {
+		struct wlr_scene_tree *tree;
+		struct wlr_scene_tree *highlight;
+		int first_row_y;
+		int height;
+	} osd_scene;
 
 	struct wl_listener destroy;
 	struct wl_listener frame;
@@ -407,6 +460,7 @@ void desktop_focus_view_or_surface(struct seat *seat, struct view *view,
 	struct wlr_surface *surface, bool raise);
 
 void desktop_arrange_all_views(struct server *server);
+void desktop_arrange_output_views(struct output *output);
 void desktop_focus_output(struct output *output);
 struct view *desktop_topmost_focusable_view(struct server *server);
 
@@ -416,6 +470,17 @@ struct view *desktop_topmost_focusable_view(struct server *server);
  */
 void desktop_update_top_layer_visiblity(struct server *server);
 
+/**
+ * desktop_node_at() - find the scene node which takes input at a position
+ * @lx, @ly: layout coordinates
+ * @sx, @sy: set to the coordinates relative to the node
+ *
+ * Like wlr_scene_node_at() but ignores overlays such as the frame stats.
+ * Returns NULL if there is no node at the position.
+ */
+struct wlr_scene_node *desktop_node_at(struct server *server,
+	double lx, double ly, double *sx, double *sy);
+
 enum lab_cycle_dir {
 	LAB_CYCLE_DIR_NONE,
 	LAB_CYCLE_DIR_FORWARD,
@@ -460,6 +525,10 @@ void seat_reset_pressed(struct seat *seat);
 void interactive_begin(struct view *view, enum input_mode mode, uint32_t edges);
 void interactive_finish(struct view *view);
 void interactive_cancel(struct view *view);
+/* Queue new geometry for the view being resized interactively */
+void interactive_resize_queue(struct view *view, struct wlr_box geo);
+/* Apply queued geometry unless a configure request is still unacked */
+void interactive_resize_flush(struct view *view);
 
 void output_init(struct server *server);
 void output_manager_init(struct server *server);
@@ -490,6 +559,8 @@ void osd_finish(struct server *server);
 void osd_preview_restore(struct server *server);
 /* Notify OSD about a destroying view */
 void osd_on_view_destroy(struct view *view);
+/* Refresh the OSD from an idle callback, coalescing multiple requests */
+void osd_schedule_update(struct server *server);
 
 /*
  * wlroots "input inhibitor" extension (required for swaylock) blocks
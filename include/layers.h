@@ -12,6 +12,10 @@ struct lab_layer_surface {
 	struct server *server;
 
 	bool mapped;
+	/* Cleared on unmap so that the next initial commit gets arranged */
+	bool arranged;
+	/* State as of the last arrangement, see layer_state_changes() */
+	struct wlr_layer_surface_v1_state arranged_state;
 
 	struct wl_listener map;
 	struct wl_listener unmap;
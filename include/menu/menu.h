@@ -2,7 +2,9 @@
 #ifndef LABWC_MENU_H
 #define LABWC_MENU_H
 
+#include <sys/types.h>
 #include <wayland-server.h>
+#include "common/buf.h"
 
 /* forward declare arguments */
 struct view;
@@ -31,9 +33,14 @@ struct menuitem {
 	struct wl_list actions;
 	struct menu *parent;
 	struct menu *submenu;
+	char *text;       /* NULL for separators */
+	bool arrow;
 	bool selectable;
 	int height;
-	int native_width;
+	int native_width; /* valid once parent->measured is set */
+	int y;            /* relative to the parent menu */
+
+	/* Scene nodes, only present while the parent menu is instantiated */
 	struct wlr_scene_tree *tree;
 	struct menu_scene normal;
 	struct menu_scene selected;
@@ -50,14 +57,39 @@ struct menu {
 		int width;
 		int height;
 	} size;
+	bool measured;
+	struct {
+		int x;
+		int y;
+	} position;
+	/* Arguments of the last menu_configure() to re-position in place */
+	struct {
+		int x;
+		int y;
+		enum menu_align align;
+	} anchor;
 	struct wl_list menuitems;
 	struct server *server;
 	struct {
 		struct menu *menu;
 		struct menuitem *item;
 	} selection;
+	/* Created when the menu is first opened, NULL after an idle release */
 	struct wlr_scene_tree *scene_tree;
 
+	/* Pipemenus only: command generating the content */
+	char *execute;
+	struct {
+		pid_t pid;       /* running generator, 0 if none */
+		int fd;
+		struct wl_event_source *source;
+		struct wl_event_source *timer;
+		struct buf output;
+		uint64_t serial; /* cache entry the content was built from */
+	} pipe;
+	/* Pipemenu whose output defined this menu, destroyed along with it */
+	struct menu *pipe_owner;
+
 	/* Used to match a window-menu to the view that triggered it. */
 	struct view *triggered_by_view;  /* may be NULL */
 	struct wl_list link; /* server.menus */
@@ -123,4 +155,14 @@ void menu_close_root(struct server *server);
 /* menu_reconfigure - reload theme and content */
 void menu_reconfigure(struct server *server);
 
+/* menu_file_changed - true if menu.xml changed since it was last read */
+bool menu_file_changed(void);
+
+/*
+ * menu_pipe_cache_finish - free the pipemenu output cache
+ *
+ * The cache survives menu_reconfigure(), call this on shutdown only.
+ */
+void menu_pipe_cache_finish(void);
+
 #endif /* LABWC_MENU_H */
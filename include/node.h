@@ -18,6 +18,7 @@ enum node_descriptor_type {
 	LAB_NODE_DESC_MENUITEM,
 	LAB_NODE_DESC_TREE,
 	LAB_NODE_DESC_SSD_BUTTON,
+	LAB_NODE_DESC_OVERLAY,
 };
 
 struct node_descriptor {
@@ -41,6 +42,7 @@ struct node_descriptor {
  *   - LAB_NODE_DESC_LAYER_POPUP    struct lab_layer_popup
  *   - LAB_NODE_DESC_MENUITEM       struct menuitem
  *   - LAB_NODE_DESC_SSD_BUTTON     struct ssd_button
+ *   - LAB_NODE_DESC_OVERLAY        NULL, the subtree never takes input
  */
 void node_descriptor_create(struct wlr_scene_node *scene_node,
 	enum node_descriptor_type type, void *data);
@@ -3,6 +3,14 @@
 #define LABWC_RESISTANCE_H
 #include "labwc.h"
 
+/**
+ * resistance_begin - snapshot the edges of other windows for
+ * <windowEdgeStrength> at the start of an interactive move/resize
+ * @view: view about to be moved or resized
+ */
+void resistance_begin(struct view *view);
+void resistance_finish(void);
+
 void resistance_move_apply(struct view *view, double *x, double *y);
 void resistance_resize_apply(struct view *view, struct wlr_box *new_view_geo);
 
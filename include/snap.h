@@ -9,6 +9,14 @@ struct wlr_box;
 
 struct border snap_get_max_distance(struct view *view);
 
+/**
+ * snap_update_view - update the edge index used by the functions below
+ * @view: view whose pending geometry or decorations have changed
+ */
+void snap_update_view(struct view *view);
+void snap_remove_view(struct view *view);
+void snap_finish(void);
+
 void snap_vector_to_next_edge(struct view *view, enum view_edge direction, int *dx, int *dy);
 int snap_distance_to_next_edge(struct view *view, enum view_edge direction);
 void snap_grow_to_next_edge(struct view *view, enum view_edge direction, struct wlr_box *geo);
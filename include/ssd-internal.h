@@ -37,6 +37,8 @@ struct ssd_sub_tree {
 struct ssd_state_title_width {
 	int width;
 	bool truncated;
+	/* Title buffer not yet rendered for the current text and width */
+	bool stale;
 };
 
 struct ssd {
@@ -50,6 +52,7 @@ struct ssd {
 	 */
 	struct {
 		bool was_maximized;   /* To un-round corner buttons and toggle icon on maximize */
+		bool active;          /* Whether the active or inactive subtrees are shown */
 		struct wlr_box geometry;
 		struct ssd_state_title {
 			char *text;
@@ -117,7 +120,8 @@ struct ssd_part *add_scene_rect(
 	float color[4]);
 struct ssd_part *add_scene_buffer(
 	struct wl_list *list, enum ssd_part_type type,
-	struct wlr_scene_tree *parent, struct wlr_buffer *buffer, int x, int y);
+	struct wlr_scene_tree *parent, struct wlr_buffer *buffer,
+	struct wlr_box geo);
 struct ssd_part *add_scene_button(
 	struct wl_list *part_list, enum ssd_part_type type,
 	struct wlr_scene_tree *parent, float *bg_color,
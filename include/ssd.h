@@ -42,11 +42,11 @@ enum ssd_part_type {
 };
 
 /* Forward declare arguments */
+struct server;
 struct ssd;
 struct ssd_button;
 struct ssd_hover_state;
 struct view;
-struct wlr_scene;
 struct wlr_scene_node;
 
 /*
@@ -78,7 +78,7 @@ struct view *ssd_button_get_view(const struct ssd_button *button);
 
 /* Public SSD helpers */
 enum ssd_part_type ssd_at(const struct ssd *ssd,
-	struct wlr_scene *scene, double lx, double ly);
+	struct server *server, double lx, double ly);
 enum ssd_part_type ssd_get_part_type(const struct ssd *ssd,
 	struct wlr_scene_node *node);
 uint32_t ssd_resize_edges(enum ssd_part_type type);
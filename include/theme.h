@@ -8,6 +8,8 @@
 #ifndef LABWC_THEME_H
 #define LABWC_THEME_H
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <wlr/render/wlr_renderer.h>
 
@@ -112,6 +114,9 @@ struct theme {
 
 	/* not set in rc.xml/themerc, but derived from font & padding_height */
 	int osd_window_switcher_item_height;
+
+	/* hash of the themerc and themerc-override key/value pairs */
+	uint64_t digest;
 };
 
 /**
@@ -119,13 +124,63 @@ struct theme {
  * @theme: theme data
  * @theme_name: theme-name in <theme-dir>/<theme-name>/openbox-3/themerc
  * Note <theme-dir> is obtained in theme-dir.c
+ *
+ * Return: true if the theme differs from the one previously loaded into
+ * @theme, i.e. the themerc key/value pairs changed or an asset had to be
+ * decoded or rendered afresh. Always true for a zeroed @theme.
  */
-void theme_init(struct theme *theme, const char *theme_name);
+bool theme_init(struct theme *theme, const char *theme_name);
 
 /**
- * theme_finish - free button textures
+ * theme_finish - release button textures
  * @theme: theme data
+ * Note: the textures stay in the asset cache so that a subsequent
+ * theme_init() can reuse the ones whose source and parameters are unchanged
  */
 void theme_finish(struct theme *theme);
 
+/**
+ * theme_buffer_at_scale - get a theme button or corner buffer rendered
+ * for an output scale
+ * @buffer: one of the button or corner buffers of struct theme
+ * @width: logical width to render at
+ * @height: logical height to render at
+ * @scale: output scale
+ *
+ * Each distinct size and scale is rendered once and then shared by all
+ * callers. The returned buffer is owned by the theme asset cache; callers
+ * that keep it must hold a lock. Returns NULL if @buffer is not a theme
+ * buffer.
+ */
+struct lab_data_buffer *theme_buffer_at_scale(struct lab_data_buffer *buffer,
+	int width, int height, double scale);
+
+/**
+ * struct theme_cache_stats - counters of the theme asset cache
+ * @hits: assets reused without decoding or rendering
+ * @misses: assets which had to be decoded or rendered
+ * @evictions: assets dropped because the theme no longer uses them
+ * @scaled: assets rendered for an output scale or size other than their own
+ * @entries: number of assets currently cached
+ */
+struct theme_cache_stats {
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+	uint64_t scaled;
+	int entries;
+};
+
+/**
+ * theme_cache_get_stats - get counters of the theme asset cache
+ * @stats: filled with the current counter values
+ */
+void theme_cache_get_stats(struct theme_cache_stats *stats);
+
+/**
+ * theme_cache_finish - free all cached theme assets
+ * Note: use on exit, after theme_finish()
+ */
+void theme_cache_finish(void);
+
 #endif /* LABWC_THEME_H */
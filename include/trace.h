@@ -0,0 +1,53 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_TRACE_H
+#define LABWC_TRACE_H
+
+#include "config.h"
+
+/*
+ * Tracing is compiled in with meson -Dtrace=enabled and costs nothing
+ * otherwise.
+ *
+ * TRACE_SCOPE("name") records the time spent in the rest of the enclosing
+ * block. @name must be a string literal. The most recent events are kept in
+ * a ring buffer and written out by trace_dump() on SIGUSR1 or the Debug
+ * action, as Chrome trace JSON for chrome://tracing or ui.perfetto.dev.
+ */
+#if HAVE_TRACE
+
+#include <stdint.h>
+
+struct trace_scope {
+	const char *name;
+	uint64_t start;
+};
+
+uint64_t trace_now(void);
+void trace_scope_end(struct trace_scope *scope);
+
+#define TRACE_PASTE(a, b) a##b
+#define TRACE_VAR(line) TRACE_PASTE(trace_scope_, line)
+#define TRACE_SCOPE(name) \
+	struct trace_scope TRACE_VAR(__LINE__) \
+		__attribute__((cleanup(trace_scope_end))) = { (name), trace_now() }
+
+/**
+ * trace_dump - write the events in the ring buffer to a file
+ *
+ * The file is created in $XDG_RUNTIME_DIR as labwc-trace-<pid>-<n>.json
+ * where n counts the dumps. The ring buffer is left untouched.
+ */
+void trace_dump(void);
+
+#else
+
+#define TRACE_SCOPE(name) do { } while (0)
+
+static inline void
+trace_dump(void)
+{
+}
+
+#endif /* HAVE_TRACE */
+
+#endif /* LABWC_TRACE_H */
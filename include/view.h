@@ -8,6 +8,9 @@
 #include <wayland-util.h>
 #include <wlr/util/box.h>
 #include <xkbcommon/xkbcommon.h>
+#include "common/border.h"
+#include "common/match.h"
+#include "window-rules.h"
 
 #define LAB_MIN_VIEW_WIDTH  100
 #define LAB_MIN_VIEW_HEIGHT  60
@@ -116,11 +119,41 @@ struct view_impl {
 	bool (*has_strut_partial)(struct view *self);
 };
 
+/**
+ * struct configure_stats - round-trip times of configure requests
+ * @count: number of configure requests acked by the client
+ * @timeouts: number of configure requests not acked in time
+ * @total_usec: sum of all round-trip times
+ * @max_usec: longest round-trip time
+ * @sent_usec: time the oldest unacked request was sent, 0 if none
+ */
+struct configure_stats {
+	uint64_t count;
+	uint64_t timeouts;
+	uint64_t total_usec;
+	uint64_t max_usec;
+	uint64_t sent_usec;
+};
+
 struct view {
 	struct server *server;
 	enum view_type type;
 	const struct view_impl *impl;
 	struct wl_list link;
+	/*
+	 * Membership lists, kept in sync with the view state so that
+	 * operations affecting a single workspace or output do not need to
+	 * filter server->views:
+	 *   workspace_link: workspace.views or server.views_always_on_top,
+	 *                   depending on the scene tree of the view. Not
+	 *                   linked for always-on-bottom views.
+	 *   output_link: output.views of view->output
+	 *   omnipresent_link: server.views_omnipresent, in the same order
+	 *                     as server.views
+	 */
+	struct wl_list workspace_link;
+	struct wl_list output_link;
+	struct wl_list omnipresent_link;
 
 	/*
 	 * The output that the view is displayed on. Specifically:
@@ -161,6 +194,9 @@ struct view {
 	/* Set to region->name when tiled_region is free'd by a destroying output */
 	char *tiled_region_evacuate;
 
+	/* Window rule properties, see window_rules_get_property() */
+	struct window_rules_cache rules_cache;
+
 	/*
 	 * Geometry of the wlr_surface contained within the view, as
 	 * currently displayed. Should be kept in sync with the
@@ -180,10 +216,40 @@ struct view {
 	 * maximized/fullscreen/tiled.
 	 */
 	struct wlr_box natural_geometry;
+	/*
+	 * Extents of the client surface including subsurfaces, relative
+	 * to the current geometry. Updated on surface commit.
+	 */
+	struct wlr_box client_extents;
+	/*
+	 * Bounding box in layout coordinates of everything which may accept
+	 * pointer input within view->scene_tree, that is the client surface,
+	 * decorations and their invisible resize extents. Used to skip views
+	 * early when hit-testing, see view_update_bounds().
+	 */
+	struct wlr_box bounds;
+	/* Outer edges as last recorded in the snap edge index, see snap.c */
+	struct border snap_edge;
+	bool snap_indexed;
 
 	/* used by xdg-shell views */
 	uint32_t pending_configure_serial;
 	struct wl_event_source *pending_configure_timeout;
+	struct configure_stats configure_stats;
+
+	/* Geometry waiting to be applied by interactive_resize_flush() */
+	struct {
+		bool queued;
+		struct wlr_box geometry;
+	} resize_queue;
+
+	/* Deferred title update, see view_schedule_title_update() */
+	struct {
+		bool pending;
+		struct wl_event_source *idle;
+		struct wl_event_source *timer;
+		uint64_t last_msec;
+	} title_update;
 
 	struct ssd *ssd;
 	struct resize_indicator {
@@ -221,6 +287,8 @@ struct view_query {
 	struct wl_list link;
 	char *identifier;
 	char *title;
+	struct glob_pattern identifier_glob;
+	struct glob_pattern title_glob;
 };
 
 struct xdg_toplevel_view {
@@ -274,6 +342,13 @@ void view_query_free(struct view_query *view);
  */
 bool view_matches_query(struct view *view, struct view_query *query);
 
+/**
+ * view_matches_criteria() - Check whether a view matches criteria.
+ * @view: View to check.
+ * @criteria: Criteria to match against.
+ */
+bool view_matches_criteria(struct view *view, enum lab_view_criteria criteria);
+
 /**
  * for_each_view() - iterate over all views which match criteria
  * @view: Iterator.
@@ -302,6 +377,21 @@ bool view_matches_query(struct view *view, struct view_query *query);
 struct view *view_next(struct wl_list *head, struct view *view,
 	enum lab_view_criteria criteria);
 
+/**
+ * for_each_view_on_workspace() - iterate over the views on a workspace,
+ * including always-on-top views, in no particular order
+ * @view: Iterator.
+ * @workspace: Workspace.
+ * The views must not be moved between workspaces while iterating.
+ */
+#define for_each_view_on_workspace(view, workspace)		\
+	for (view = view_next_on_workspace(workspace, NULL);	\
+	     view;						\
+	     view = view_next_on_workspace(workspace, view))
+
+struct view *view_next_on_workspace(struct workspace *workspace,
+	struct view *view);
+
 /**
  * view_array_append() - Append views that match criteria to array
  * @server: server context
@@ -443,6 +533,22 @@ bool view_has_strut_partial(struct view *view);
 
 const char *view_get_string_prop(struct view *view, const char *prop);
 void view_update_title(struct view *view);
+
+/**
+ * view_update_bounds() - recalculate view->bounds
+ * @view: view whose geometry, decorations or client extents changed
+ */
+void view_update_bounds(struct view *view);
+
+/**
+ * view_schedule_title_update() - update title related state later
+ * @view: view whose title has changed
+ *
+ * Multiple title changes are collapsed into a single view_update_title()
+ * which runs once the event loop is idle, but not earlier than
+ * <core><titleUpdateInterval> after the previous update of the view.
+ */
+void view_schedule_title_update(struct view *view);
 void view_update_app_id(struct view *view);
 void view_reload_ssd(struct view *view);
 
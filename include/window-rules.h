@@ -2,6 +2,11 @@
 #ifndef LABWC_WINDOW_RULES_H
 #define LABWC_WINDOW_RULES_H
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <wayland-util.h>
+#include "common/match.h"
+
 enum window_rule_event {
 	LAB_WINDOW_RULE_EVENT_ON_FIRST_MAP = 0,
 };
@@ -13,6 +18,26 @@ enum property {
 	LAB_PROP_TRUE,
 };
 
+enum window_rule_property {
+	LAB_RULE_PROP_SERVER_DECORATION = 0,
+	LAB_RULE_PROP_SKIP_TASKBAR,
+	LAB_RULE_PROP_SKIP_WINDOW_SWITCHER,
+	LAB_RULE_PROP_IGNORE_FOCUS_REQUEST,
+	LAB_RULE_PROP_FIXED_POSITION,
+
+	LAB_RULE_PROP_COUNT
+};
+
+/*
+ * Per-view result of matching all window rules. Each property takes two
+ * bits in 'properties' (enum property fits). The cache is valid as long as
+ * 'generation' matches the generation in window-rules.c.
+ */
+struct window_rules_cache {
+	uint32_t generation;
+	uint32_t properties;
+};
+
 /*
  * 'identifier' represents:
  *   - 'app_id' for native Wayland windows
@@ -21,6 +46,8 @@ enum property {
 struct window_rule {
 	char *identifier;
 	char *title;
+	struct glob_pattern identifier_glob;
+	struct glob_pattern title_glob;
 	bool match_once;
 
 	enum window_rule_event event;
@@ -38,6 +65,16 @@ struct window_rule {
 struct view;
 
 void window_rules_apply(struct view *view, enum window_rule_event event);
-enum property window_rules_get_property(struct view *view, const char *property);
+enum property window_rules_get_property(struct view *view,
+	enum window_rule_property property);
+
+/**
+ * window_rules_invalidate - drop cached window rule properties
+ * @view: view whose app_id or title changed, or NULL after the rules changed
+ *
+ * If any rule uses matchOnce, the properties of all views depend on each
+ * other and the whole cache is dropped.
+ */
+void window_rules_invalidate(struct view *view);
 
 #endif /* LABWC_WINDOW_RULES_H */
@@ -19,6 +19,7 @@ struct workspace {
 
 	char *name;
 	struct wlr_scene_tree *tree;
+	struct wl_list views; /* struct view.workspace_link, views in @tree */
 };
 
 void workspaces_init(struct server *server);
@@ -41,6 +41,14 @@ struct xwayland_view {
 	struct wl_listener set_override_redirect;
 	struct wl_listener set_strut_partial;
 
+	/*
+	 * Linked in server.strut_views while mapped with a strut. The strut
+	 * is copied so that property updates which do not change it can be
+	 * told apart from ones that do.
+	 */
+	struct wl_list strut_link;
+	xcb_ewmh_wm_strut_partial_t strut;
+
 	/* Not (yet) implemented */
 /*	struct wl_listener set_role; */
 /*	struct wl_listener set_window_type; */
@@ -14,48 +14,15 @@
 #include "common/spawn.h"
 #include "common/string-helpers.h"
 #include "debug.h"
+#include "frame-stats.h"
 #include "labwc.h"
 #include "menu/menu.h"
 #include "regions.h"
 #include "ssd.h"
+#include "trace.h"
 #include "view.h"
 #include "workspaces.h"
 
-enum action_arg_type {
-	LAB_ACTION_ARG_STR = 0,
-	LAB_ACTION_ARG_BOOL,
-	LAB_ACTION_ARG_INT,
-	LAB_ACTION_ARG_QUERY_LIST,
-	LAB_ACTION_ARG_ACTION_LIST,
-};
-
-struct action_arg {
-	struct wl_list link;        /* struct action.args */
-
-	char *key;                  /* May be NULL if there is just one arg */
-	enum action_arg_type type;
-};
-
-struct action_arg_str {
-	struct action_arg base;
-	char *value;
-};
-
-struct action_arg_bool {
-	struct action_arg base;
-	bool value;
-};
-
-struct action_arg_int {
-	struct action_arg base;
-	int value;
-};
-
-struct action_arg_list {
-	struct action_arg base;
-	struct wl_list value;
-};
-
 enum action_type {
 	ACTION_TYPE_INVALID = 0,
 	ACTION_TYPE_NONE,
@@ -100,6 +67,7 @@ enum action_type {
 	ACTION_TYPE_FOR_EACH,
 	ACTION_TYPE_VIRTUAL_OUTPUT_ADD,
 	ACTION_TYPE_VIRTUAL_OUTPUT_REMOVE,
+	ACTION_TYPE_TOGGLE_FRAME_STATS,
 };
 
 const char *action_names[] = {
@@ -146,117 +114,54 @@ const char *action_names[] = {
 	"ForEach",
 	"VirtualOutputAdd",
 	"VirtualOutputRemove",
+	"ToggleFrameStats",
 	NULL
 };
 
-void
-action_arg_add_str(struct action *action, const char *key, const char *value)
-{
-	assert(action);
-	assert(key);
-	assert(value && "Tried to add NULL action string argument");
-	struct action_arg_str *arg = znew(*arg);
-	arg->base.type = LAB_ACTION_ARG_STR;
-	arg->base.key = xstrdup(key);
-	arg->value = xstrdup(value);
-	wl_list_append(&action->args, &arg->base.link);
-}
-
-static void
-action_arg_add_bool(struct action *action, const char *key, bool value)
-{
-	assert(action);
-	assert(key);
-	struct action_arg_bool *arg = znew(*arg);
-	arg->base.type = LAB_ACTION_ARG_BOOL;
-	arg->base.key = xstrdup(key);
-	arg->value = value;
-	wl_list_append(&action->args, &arg->base.link);
-}
-
 static void
-action_arg_add_int(struct action *action, const char *key, int value)
+set_str(char **dest, const char *value)
 {
-	assert(action);
-	assert(key);
-	struct action_arg_int *arg = znew(*arg);
-	arg->base.type = LAB_ACTION_ARG_INT;
-	arg->base.key = xstrdup(key);
-	arg->value = value;
-	wl_list_append(&action->args, &arg->base.link);
+	free(*dest);
+	*dest = xstrdup(value);
 }
 
 static void
-action_arg_add_list(struct action *action, const char *key, enum action_arg_type type)
-{
-	assert(action);
-	assert(key);
-	struct action_arg_list *arg = znew(*arg);
-	arg->base.type = type;
-	arg->base.key = xstrdup(key);
-	wl_list_init(&arg->value);
-	wl_list_append(&action->args, &arg->base.link);
-}
-
-void
-action_arg_add_querylist(struct action *action, const char *key)
+set_command(struct action *action, const char *command)
 {
-	action_arg_add_list(action, key, LAB_ACTION_ARG_QUERY_LIST);
-}
-
-void
-action_arg_add_actionlist(struct action *action, const char *key)
-{
-	action_arg_add_list(action, key, LAB_ACTION_ARG_ACTION_LIST);
-}
-
-static void *
-action_get_arg(struct action *action, const char *key, enum action_arg_type type)
-{
-	assert(action);
-	assert(key);
-	struct action_arg *arg;
-	wl_list_for_each(arg, &action->args, link) {
-		if (!strcasecmp(key, arg->key) && arg->type == type) {
-			return arg;
-		}
-	}
-	return NULL;
-}
-
-static const char *
-action_get_str(struct action *action, const char *key, const char *default_value)
-{
-	struct action_arg_str *arg = action_get_arg(action, key, LAB_ACTION_ARG_STR);
-	return arg ? arg->value : default_value;
+	struct buf cmd;
+	buf_init(&cmd);
+	buf_add(&cmd, command);
+	buf_expand_tilde(&cmd);
+	spawn_argv_free(action->args.execute.argv);
+	action->args.execute.argv = spawn_parse_argv(cmd.buf);
+	free(cmd.buf);
 }
 
 static bool
-action_get_bool(struct action *action, const char *key, bool default_value)
-{
-	struct action_arg_bool *arg = action_get_arg(action, key, LAB_ACTION_ARG_BOOL);
-	return arg ? arg->value : default_value;
-}
-
-static int
-action_get_int(struct action *action, const char *key, int default_value)
+action_has_lists(struct action *action)
 {
-	struct action_arg_int *arg = action_get_arg(action, key, LAB_ACTION_ARG_INT);
-	return arg ? arg->value : default_value;
+	return action && (action->type == ACTION_TYPE_IF
+		|| action->type == ACTION_TYPE_FOR_EACH);
 }
 
 struct wl_list *
-action_get_querylist(struct action *action, const char *key)
+action_get_querylist(struct action *action)
 {
-	struct action_arg_list *arg = action_get_arg(action, key, LAB_ACTION_ARG_QUERY_LIST);
-	return arg ? &arg->value : NULL;
+	return action_has_lists(action) ? &action->args.cond.queries : NULL;
 }
 
 struct wl_list *
-action_get_actionlist(struct action *action, const char *key)
+action_get_actionlist(struct action *action, const char *branch)
 {
-	struct action_arg_list *arg = action_get_arg(action, key, LAB_ACTION_ARG_ACTION_LIST);
-	return arg ? &arg->value : NULL;
+	if (!action_has_lists(action)) {
+		return NULL;
+	}
+	if (!strcasecmp(branch, "then")) {
+		return &action->args.cond.then;
+	} else if (!strcasecmp(branch, "else")) {
+		return &action->args.cond.otherwise;
+	}
+	return NULL;
 }
 
 void
@@ -275,13 +180,13 @@ action_arg_from_xml_node(struct action *action, const char *nodename, const char
 		 * compatibility with old openbox-menu generators
 		 */
 		if (!strcmp(argument, "command") || !strcmp(argument, "execute")) {
-			action_arg_add_str(action, "command", content);
+			set_command(action, content);
 			goto cleanup;
 		}
 		break;
 	case ACTION_TYPE_MOVE_TO_EDGE:
 		if (!strcasecmp(argument, "snapWindows")) {
-			action_arg_add_bool(action, argument, parse_bool(content, true));
+			action->args.edge.snap_windows = parse_bool(content, true);
 			goto cleanup;
 		}
 		/* Falls through */
@@ -295,14 +200,14 @@ action_arg_from_xml_node(struct action *action, const char *nodename, const char
 				wlr_log(WLR_ERROR, "Invalid argument for action %s: '%s' (%s)",
 					action_names[action->type], argument, content);
 			} else {
-				action_arg_add_int(action, argument, edge);
+				action->args.edge.direction = edge;
 			}
 			goto cleanup;
 		}
 		break;
 	case ACTION_TYPE_SHOW_MENU:
 		if (!strcmp(argument, "menu")) {
-			action_arg_add_str(action, argument, content);
+			set_str(&action->args.target.name, content);
 			goto cleanup;
 		}
 		break;
@@ -314,63 +219,77 @@ action_arg_from_xml_node(struct action *action, const char *nodename, const char
 				wlr_log(WLR_ERROR, "Invalid argument for action %s: '%s' (%s)",
 					action_names[action->type], argument, content);
 			} else {
-				action_arg_add_int(action, argument, axis);
+				action->args.maximize.direction = axis;
 			}
 			goto cleanup;
 		}
 		break;
 	case ACTION_TYPE_RESIZE_RELATIVE:
-		if (!strcmp(argument, "left") || !strcmp(argument, "right") ||
-				!strcmp(argument, "top") || !strcmp(argument, "bottom")) {
-			action_arg_add_int(action, argument, atoi(content));
+		if (!strcmp(argument, "left")) {
+			action->args.resize_relative.left = atoi(content);
+			goto cleanup;
+		} else if (!strcmp(argument, "right")) {
+			action->args.resize_relative.right = atoi(content);
+			goto cleanup;
+		} else if (!strcmp(argument, "top")) {
+			action->args.resize_relative.top = atoi(content);
+			goto cleanup;
+		} else if (!strcmp(argument, "bottom")) {
+			action->args.resize_relative.bottom = atoi(content);
 			goto cleanup;
 		}
 		break;
 	case ACTION_TYPE_MOVETO:
 	case ACTION_TYPE_MOVE_RELATIVE:
-		if (!strcmp(argument, "x") || !strcmp(argument, "y")) {
-			action_arg_add_int(action, argument, atoi(content));
+		if (!strcmp(argument, "x")) {
+			action->args.move.x = atoi(content);
+			goto cleanup;
+		} else if (!strcmp(argument, "y")) {
+			action->args.move.y = atoi(content);
 			goto cleanup;
 		}
 		break;
 	case ACTION_TYPE_RESIZETO:
-		if (!strcmp(argument, "width") || !strcmp(argument, "height")) {
-			action_arg_add_int(action, argument, atoi(content));
+		if (!strcmp(argument, "width")) {
+			action->args.resize_to.width = atoi(content);
+			goto cleanup;
+		} else if (!strcmp(argument, "height")) {
+			action->args.resize_to.height = atoi(content);
 			goto cleanup;
 		}
 		break;
 	case ACTION_TYPE_SEND_TO_DESKTOP:
 		if (!strcmp(argument, "follow")) {
-			action_arg_add_bool(action, argument, parse_bool(content, true));
+			action->args.desktop.follow = parse_bool(content, true);
 			goto cleanup;
 		}
 		/* Falls through to GoToDesktop */
 	case ACTION_TYPE_GO_TO_DESKTOP:
 		if (!strcmp(argument, "to")) {
-			action_arg_add_str(action, argument, content);
+			set_str(&action->args.desktop.to, content);
 			goto cleanup;
 		}
 		if (!strcmp(argument, "wrap")) {
-			action_arg_add_bool(action, argument, parse_bool(content, true));
+			action->args.desktop.wrap = parse_bool(content, true);
 			goto cleanup;
 		}
 		break;
 	case ACTION_TYPE_SNAP_TO_REGION:
 		if (!strcmp(argument, "region")) {
-			action_arg_add_str(action, argument, content);
+			set_str(&action->args.target.name, content);
 			goto cleanup;
 		}
 		break;
 	case ACTION_TYPE_FOCUS_OUTPUT:
 		if (!strcmp(argument, "output")) {
-			action_arg_add_str(action, argument, content);
+			set_str(&action->args.target.name, content);
 			goto cleanup;
 		}
 		break;
 	case ACTION_TYPE_VIRTUAL_OUTPUT_ADD:
 	case ACTION_TYPE_VIRTUAL_OUTPUT_REMOVE:
 		if (!strcmp(argument, "output_name")) {
-			action_arg_add_str(action, argument, content);
+			set_str(&action->args.target.name, content);
 			goto cleanup;
 		}
 		break;
@@ -410,7 +329,30 @@ action_create(const char *action_name)
 
 	struct action *action = znew(*action);
 	action->type = action_type;
-	wl_list_init(&action->args);
+
+	/* Defaults for arguments which are not given in rc.xml */
+	switch (action_type) {
+	case ACTION_TYPE_MOVE_TO_EDGE:
+		action->args.edge.snap_windows = true;
+		break;
+	case ACTION_TYPE_TOGGLE_MAXIMIZE:
+	case ACTION_TYPE_MAXIMIZE:
+		action->args.maximize.direction = VIEW_AXIS_BOTH;
+		break;
+	case ACTION_TYPE_SEND_TO_DESKTOP:
+	case ACTION_TYPE_GO_TO_DESKTOP:
+		action->args.desktop.follow = true;
+		action->args.desktop.wrap = true;
+		break;
+	case ACTION_TYPE_IF:
+	case ACTION_TYPE_FOR_EACH:
+		wl_list_init(&action->args.cond.queries);
+		wl_list_init(&action->args.cond.then);
+		wl_list_init(&action->args.cond.otherwise);
+		break;
+	default:
+		break;
+	}
 	return action;
 }
 
@@ -445,31 +387,36 @@ bool
 action_is_valid(struct action *action)
 {
 	const char *arg_name = NULL;
-	enum action_arg_type arg_type = LAB_ACTION_ARG_STR;
+	bool present = false;
 
 	switch (action->type) {
 	case ACTION_TYPE_EXECUTE:
 		arg_name = "command";
+		present = action->args.execute.argv;
 		break;
 	case ACTION_TYPE_MOVE_TO_EDGE:
 	case ACTION_TYPE_SNAP_TO_EDGE:
 	case ACTION_TYPE_GROW_TO_EDGE:
 	case ACTION_TYPE_SHRINK_TO_EDGE:
 		arg_name = "direction";
-		arg_type = LAB_ACTION_ARG_INT;
+		present = action->args.edge.direction != VIEW_EDGE_INVALID;
 		break;
 	case ACTION_TYPE_SHOW_MENU:
 		arg_name = "menu";
+		present = action->args.target.name;
 		break;
 	case ACTION_TYPE_GO_TO_DESKTOP:
 	case ACTION_TYPE_SEND_TO_DESKTOP:
 		arg_name = "to";
+		present = action->args.desktop.to;
 		break;
 	case ACTION_TYPE_SNAP_TO_REGION:
 		arg_name = "region";
+		present = action->args.target.name;
 		break;
 	case ACTION_TYPE_FOCUS_OUTPUT:
 		arg_name = "output";
+		present = action->args.target.name;
 		break;
 	case ACTION_TYPE_IF:
 	case ACTION_TYPE_FOR_EACH:
@@ -477,7 +424,7 @@ action_is_valid(struct action *action)
 		static const char * const branches[] = { "then", "else" };
 		for (size_t i = 0; i < ARRAY_SIZE(branches); i++) {
 			struct wl_list *children = action_get_actionlist(action, branches[i]);
-			if (children && !action_list_is_valid(children)) {
+			if (!action_list_is_valid(children)) {
 				wlr_log(WLR_ERROR, "Invalid action in %s '%s' branch",
 					action_names[action->type], branches[i]);
 				return false;
@@ -489,7 +436,7 @@ action_is_valid(struct action *action)
 		return true;
 	}
 
-	if (action_get_arg(action, arg_name, arg_type)) {
+	if (present) {
 		return true;
 	}
 
@@ -501,25 +448,33 @@ action_is_valid(struct action *action)
 void
 action_free(struct action *action)
 {
-	/* Free args */
-	struct action_arg *arg, *arg_tmp;
-	wl_list_for_each_safe(arg, arg_tmp, &action->args, link) {
-		wl_list_remove(&arg->link);
-		zfree(arg->key);
-		if (arg->type == LAB_ACTION_ARG_STR) {
-			struct action_arg_str *str_arg = (struct action_arg_str *)arg;
-			zfree(str_arg->value);
-		} else if (arg->type == LAB_ACTION_ARG_ACTION_LIST) {
-			struct action_arg_list *list_arg = (struct action_arg_list *)arg;
-			action_list_free(&list_arg->value);
-		} else if (arg->type == LAB_ACTION_ARG_QUERY_LIST) {
-			struct action_arg_list *list_arg = (struct action_arg_list *)arg;
-			struct view_query *elm, *next;
-			wl_list_for_each_safe(elm, next, &list_arg->value, link) {
-				view_query_free(elm);
-			}
+	switch (action->type) {
+	case ACTION_TYPE_EXECUTE:
+		spawn_argv_free(action->args.execute.argv);
+		break;
+	case ACTION_TYPE_SEND_TO_DESKTOP:
+	case ACTION_TYPE_GO_TO_DESKTOP:
+		zfree(action->args.desktop.to);
+		break;
+	case ACTION_TYPE_SHOW_MENU:
+	case ACTION_TYPE_SNAP_TO_REGION:
+	case ACTION_TYPE_FOCUS_OUTPUT:
+	case ACTION_TYPE_VIRTUAL_OUTPUT_ADD:
+	case ACTION_TYPE_VIRTUAL_OUTPUT_REMOVE:
+		zfree(action->args.target.name);
+		break;
+	case ACTION_TYPE_IF:
+	case ACTION_TYPE_FOR_EACH:
+		; /* works around "a label can only be part of a statement" */
+		struct view_query *elm, *next;
+		wl_list_for_each_safe(elm, next, &action->args.cond.queries, link) {
+			view_query_free(elm);
 		}
-		zfree(arg);
+		action_list_free(&action->args.cond.then);
+		action_list_free(&action->args.cond.otherwise);
+		break;
+	default:
+		break;
 	}
 	zfree(action);
 }
@@ -552,7 +507,7 @@ show_menu(struct server *server, struct view *view, const char *menu_name)
 		if (!view) {
 			return;
 		}
-		enum ssd_part_type type = ssd_at(view->ssd, server->scene,
+		enum ssd_part_type type = ssd_at(view->ssd, server,
 			server->seat.cursor->x, server->seat.cursor->y);
 		if (type == LAB_SSD_BUTTON_WINDOW_MENU) {
 			force_menu_top_left = true;
@@ -606,24 +561,22 @@ view_for_action(struct view *activator, struct server *server,
 static void
 run_if_action(struct view *view, struct server *server, struct action *action)
 {
-	struct view_query *query;
-	struct wl_list *queries, *actions;
-	const char *branch = "then";
+	struct wl_list *actions = &action->args.cond.then;
 
-	queries = action_get_querylist(action, "query");
-	if (queries) {
-		branch = "else";
+	struct wl_list *queries = &action->args.cond.queries;
+	if (!wl_list_empty(queries)) {
+		actions = &action->args.cond.otherwise;
 		/* All queries are OR'ed */
+		struct view_query *query;
 		wl_list_for_each(query, queries, link) {
 			if (view_matches_query(view, query)) {
-				branch = "then";
+				actions = &action->args.cond.then;
 				break;
 			}
 		}
 	}
 
-	actions = action_get_actionlist(action, branch);
-	if (actions) {
+	if (!wl_list_empty(actions)) {
 		actions_run(view, server, actions, 0);
 	}
 }
@@ -632,6 +585,7 @@ void
 actions_run(struct view *activator, struct server *server,
 	struct wl_list *actions, uint32_t resize_edges)
 {
+	TRACE_SCOPE("actions_run");
 	if (!actions) {
 		wlr_log(WLR_ERROR, "empty actions");
 		return;
@@ -669,16 +623,11 @@ actions_run(struct view *activator, struct server *server,
 			break;
 		case ACTION_TYPE_DEBUG:
 			debug_dump_scene(server);
+			frame_stats_dump(server);
+			trace_dump();
 			break;
 		case ACTION_TYPE_EXECUTE:
-			{
-				struct buf cmd;
-				buf_init(&cmd);
-				buf_add(&cmd, action_get_str(action, "command", NULL));
-				buf_expand_tilde(&cmd);
-				spawn_async_no_shell(cmd.buf);
-				free(cmd.buf);
-			}
+			spawn_async_argv(action->args.execute.argv);
 			break;
 		case ACTION_TYPE_EXIT:
 			wl_display_terminate(server->wl_display);
@@ -686,16 +635,14 @@ actions_run(struct view *activator, struct server *server,
 		case ACTION_TYPE_MOVE_TO_EDGE:
 			if (view) {
 				/* Config parsing makes sure that direction is a valid direction */
-				enum view_edge edge = action_get_int(action, "direction", 0);
-				bool snap_to_windows = action_get_bool(action, "snapWindows", true);
-				view_move_to_edge(view, edge, snap_to_windows);
+				view_move_to_edge(view, action->args.edge.direction,
+					action->args.edge.snap_windows);
 			}
 			break;
 		case ACTION_TYPE_SNAP_TO_EDGE:
 			if (view) {
 				/* Config parsing makes sure that direction is a valid direction */
-				enum view_edge edge = action_get_int(action, "direction", 0);
-				view_snap_to_edge(view, edge,
+				view_snap_to_edge(view, action->args.edge.direction,
 					/*across_outputs*/ true,
 					/*store_natural_geometry*/ true);
 			}
@@ -703,15 +650,13 @@ actions_run(struct view *activator, struct server *server,
 		case ACTION_TYPE_GROW_TO_EDGE:
 			if (view) {
 				/* Config parsing makes sure that direction is a valid direction */
-				enum view_edge edge = action_get_int(action, "direction", 0);
-				view_grow_to_edge(view, edge);
+				view_grow_to_edge(view, action->args.edge.direction);
 			}
 			break;
 		case ACTION_TYPE_SHRINK_TO_EDGE:
 			if (view) {
 				/* Config parsing makes sure that direction is a valid direction */
-				enum view_edge edge = action_get_int(action, "direction", 0);
-				view_shrink_to_edge(view, edge);
+				view_shrink_to_edge(view, action->args.edge.direction);
 			}
 			break;
 		case ACTION_TYPE_NEXT_WINDOW:
@@ -728,20 +673,17 @@ actions_run(struct view *activator, struct server *server,
 			kill(getpid(), SIGHUP);
 			break;
 		case ACTION_TYPE_SHOW_MENU:
-			show_menu(server, view, action_get_str(action, "menu", NULL));
+			show_menu(server, view, action->args.target.name);
 			break;
 		case ACTION_TYPE_TOGGLE_MAXIMIZE:
 			if (view) {
-				enum view_axis axis = action_get_int(action,
-					"direction", VIEW_AXIS_BOTH);
-				view_toggle_maximize(view, axis);
+				view_toggle_maximize(view,
+					action->args.maximize.direction);
 			}
 			break;
 		case ACTION_TYPE_MAXIMIZE:
 			if (view) {
-				enum view_axis axis = action_get_int(action,
-					"direction", VIEW_AXIS_BOTH);
-				view_maximize(view, axis,
+				view_maximize(view, action->args.maximize.direction,
 					/*store_natural_geometry*/ true);
 			}
 			break;
@@ -806,24 +748,23 @@ actions_run(struct view *activator, struct server *server,
 			break;
 		case ACTION_TYPE_RESIZE_RELATIVE:
 			if (view) {
-				int left = action_get_int(action, "left", 0);
-				int right = action_get_int(action, "right", 0);
-				int top = action_get_int(action, "top", 0);
-				int bottom = action_get_int(action, "bottom", 0);
-				view_resize_relative(view, left, right, top, bottom);
+				view_resize_relative(view,
+					action->args.resize_relative.left,
+					action->args.resize_relative.right,
+					action->args.resize_relative.top,
+					action->args.resize_relative.bottom);
 			}
 			break;
 		case ACTION_TYPE_MOVETO:
 			if (view) {
-				int x = action_get_int(action, "x", 0);
-				int y = action_get_int(action, "y", 0);
-				view_move(view, x, y);
+				view_move(view, action->args.move.x,
+					action->args.move.y);
 			}
 			break;
 		case ACTION_TYPE_RESIZETO:
 			if (view) {
-				int width = action_get_int(action, "width", 0);
-				int height = action_get_int(action, "height", 0);
+				int width = action->args.resize_to.width;
+				int height = action->args.resize_to.height;
 
 				/*
 				 * To support only setting one of width/height
@@ -841,9 +782,8 @@ actions_run(struct view *activator, struct server *server,
 			break;
 		case ACTION_TYPE_MOVE_RELATIVE:
 			if (view) {
-				int x = action_get_int(action, "x", 0);
-				int y = action_get_int(action, "y", 0);
-				view_move_relative(view, x, y);
+				view_move_relative(view, action->args.move.x,
+					action->args.move.y);
 			}
 			break;
 		case ACTION_TYPE_MOVETO_CURSOR:
@@ -859,8 +799,8 @@ actions_run(struct view *activator, struct server *server,
 		case ACTION_TYPE_GO_TO_DESKTOP:
 			{
 				bool follow = true;
-				bool wrap = action_get_bool(action, "wrap", true);
-				const char *to = action_get_str(action, "to", NULL);
+				bool wrap = action->args.desktop.wrap;
+				const char *to = action->args.desktop.to;
 				/*
 				 * `to` is always != NULL here because otherwise we would have
 				 * removed the action during the initial parsing step as it is
@@ -873,7 +813,7 @@ actions_run(struct view *activator, struct server *server,
 				}
 				if (action->type == ACTION_TYPE_SEND_TO_DESKTOP) {
 					view_move_to_workspace(view, target);
-					follow = action_get_bool(action, "follow", true);
+					follow = action->args.desktop.follow;
 				}
 				if (follow) {
 					workspaces_switch_to(target,
@@ -889,7 +829,7 @@ actions_run(struct view *activator, struct server *server,
 			if (!output) {
 				break;
 			}
-			const char *region_name = action_get_str(action, "region", NULL);
+			const char *region_name = action->args.target.name;
 			struct region *region = regions_from_name(region_name, output);
 			if (region) {
 				view_snap_to_region(view, region,
@@ -905,8 +845,8 @@ actions_run(struct view *activator, struct server *server,
 			break;
 		case ACTION_TYPE_FOCUS_OUTPUT:
 			{
-				const char *output_name = action_get_str(action, "output", NULL);
-				desktop_focus_output(output_from_name(server, output_name));
+				desktop_focus_output(output_from_name(server,
+					action->args.target.name));
 			}
 			break;
 		case ACTION_TYPE_IF:
@@ -928,18 +868,19 @@ actions_run(struct view *activator, struct server *server,
 			break;
 		case ACTION_TYPE_VIRTUAL_OUTPUT_ADD:
 			{
-				const char *output_name = action_get_str(action, "output_name",
-						NULL);
+				const char *output_name = action->args.target.name;
 				output_add_virtual(server, output_name);
 			}
 			break;
 		case ACTION_TYPE_VIRTUAL_OUTPUT_REMOVE:
 			{
-				const char *output_name = action_get_str(action, "output_name",
-						NULL);
+				const char *output_name = action->args.target.name;
 				output_remove_virtual(server, output_name);
 			}
 			break;
+		case ACTION_TYPE_TOGGLE_FRAME_STATS:
+			frame_stats_overlay_toggle(server);
+			break;
 		case ACTION_TYPE_INVALID:
 			wlr_log(WLR_ERROR, "Not executing unknown action");
 			break;
@@ -1,5 +1,5 @@
 // SPDX-License-Identifier: GPL-2.0-only
-#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
 
 #include <sys/resource.h>
 #include <wlr/util/log.h>
@@ -28,15 +28,34 @@ increase_nofile_limit(void)
 	}
 }
 
-void
+bool
 restore_nofile_limit(void)
 {
 	if (original_nofile_rlimit.rlim_cur == 0) {
-		return;
+		return false;
 	}
 
 	if (setrlimit(RLIMIT_NOFILE, &original_nofile_rlimit) != 0) {
 		wlr_log_errno(WLR_ERROR,
 			"Failed to restore max open files limit: setrlimit(NOFILE) failed");
+		return false;
+	}
+	return true;
+}
+
+#ifdef __linux__
+bool
+restore_nofile_limit_of(pid_t pid)
+{
+	if (original_nofile_rlimit.rlim_cur == 0) {
+		return false;
+	}
+
+	if (prlimit(pid, RLIMIT_NOFILE, &original_nofile_rlimit, NULL) != 0) {
+		wlr_log_errno(WLR_ERROR,
+			"Failed to restore max open files limit: prlimit(NOFILE) failed");
+		return false;
 	}
+	return true;
 }
+#endif
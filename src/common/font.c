@@ -2,14 +2,60 @@
 #include <cairo.h>
 #include <drm_fourcc.h>
 #include <pango/pangocairo.h>
+#include <string.h>
 #include <wlr/render/wlr_renderer.h>
 #include <wlr/util/box.h>
 #include <wlr/util/log.h>
 #include "common/font.h"
 #include "common/graphic-helpers.h"
+#include "common/mem.h"
 #include "labwc.h"
 #include "buffer.h"
 
+/*
+ * Measuring text requires shaping it with pango, which is expensive enough
+ * to show up when building large menus or when clients update their titles
+ * frequently. The results are therefore kept in a process-wide LRU cache.
+ *
+ * Text extents are measured on an unscaled layout without width limit, so
+ * they only depend on the font and the string. Output scale and max width
+ * are applied by the callers afterwards and are not part of the key.
+ */
+#define FONT_CACHE_MAX_ENTRIES 512
+#define FONT_CACHE_BUCKETS 1024 /* power of two */
+
+struct font_desc {
+	char *name;
+	int size;
+	enum font_slant slant;
+	enum font_weight weight;
+	PangoFontDescription *desc;
+	struct wl_list link; /* font_cache.fonts */
+};
+
+struct font_extents_entry {
+	struct font_desc *font;
+	char *text;
+	uint32_t hash;
+	PangoRectangle rect;
+	struct font_extents_entry *next; /* font_cache.buckets[] */
+	struct wl_list link; /* font_cache.lru, most recently used first */
+};
+
+static struct {
+	/* Long-lived context used for all measurements */
+	cairo_surface_t *surface;
+	cairo_t *cairo;
+	PangoLayout *layout;
+	struct font_desc *layout_font;
+
+	struct wl_list fonts;
+	struct wl_list lru;
+	struct font_extents_entry *buckets[FONT_CACHE_BUCKETS];
+	int nr_entries;
+	struct font_cache_stats stats;
+} font_cache;
+
 PangoFontDescription *
 font_to_pango_desc(struct font *font)
 {
@@ -25,6 +71,86 @@ font_to_pango_desc(struct font *font)
 	return desc;
 }
 
+static struct font_desc *
+font_desc_get(struct font *font)
+{
+	if (!font_cache.fonts.next) {
+		wl_list_init(&font_cache.fonts);
+		wl_list_init(&font_cache.lru);
+	}
+
+	struct font_desc *font_desc;
+	wl_list_for_each(font_desc, &font_cache.fonts, link) {
+		if (font_desc->size == font->size
+				&& font_desc->slant == font->slant
+				&& font_desc->weight == font->weight
+				&& !g_strcmp0(font_desc->name, font->name)) {
+			return font_desc;
+		}
+	}
+
+	font_desc = znew(*font_desc);
+	font_desc->name = font->name ? xstrdup(font->name) : NULL;
+	font_desc->size = font->size;
+	font_desc->slant = font->slant;
+	font_desc->weight = font->weight;
+	font_desc->desc = font_to_pango_desc(font);
+	wl_list_insert(&font_cache.fonts, &font_desc->link);
+	return font_desc;
+}
+
+static uint32_t
+font_extents_hash(struct font_desc *font, const char *string)
+{
+	/* FNV-1a, seeded with the font so equal strings spread out */
+	uint32_t hash = 2166136261u ^ (uint32_t)(uintptr_t)font;
+	for (const unsigned char *p = (const unsigned char *)string; *p; p++) {
+		hash ^= *p;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static void
+font_extents_entry_destroy(struct font_extents_entry *entry)
+{
+	struct font_extents_entry **prev =
+		&font_cache.buckets[entry->hash & (FONT_CACHE_BUCKETS - 1)];
+	while (*prev != entry) {
+		prev = &(*prev)->next;
+	}
+	*prev = entry->next;
+	wl_list_remove(&entry->link);
+	free(entry->text);
+	free(entry);
+	font_cache.nr_entries--;
+}
+
+static PangoRectangle
+font_extents_measure(struct font_desc *font, const char *string)
+{
+	if (!font_cache.layout) {
+		font_cache.surface =
+			cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
+		font_cache.cairo = cairo_create(font_cache.surface);
+		font_cache.layout = pango_cairo_create_layout(font_cache.cairo);
+		pango_layout_set_single_paragraph_mode(font_cache.layout, TRUE);
+		pango_layout_set_width(font_cache.layout, -1);
+		pango_layout_set_ellipsize(font_cache.layout,
+			PANGO_ELLIPSIZE_MIDDLE);
+	}
+	if (font_cache.layout_font != font) {
+		pango_layout_set_font_description(font_cache.layout, font->desc);
+		font_cache.layout_font = font;
+	}
+
+	PangoRectangle rect = { 0 };
+	pango_layout_set_text(font_cache.layout, string, -1);
+	pango_layout_get_extents(font_cache.layout, NULL, &rect);
+	pango_extents_to_pixels(&rect, NULL);
+	return rect;
+}
+
 static PangoRectangle
 font_extents(struct font *font, const char *string)
 {
@@ -32,31 +158,45 @@ font_extents(struct font *font, const char *string)
 	if (!string) {
 		return rect;
 	}
-	cairo_surface_t *surface;
-	cairo_t *c;
-	PangoLayout *layout;
 
-	surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
-	c = cairo_create(surface);
-	layout = pango_cairo_create_layout(c);
-	PangoFontDescription *desc = font_to_pango_desc(font);
-
-	pango_layout_set_font_description(layout, desc);
-	pango_layout_set_text(layout, string, -1);
-	pango_layout_set_single_paragraph_mode(layout, TRUE);
-	pango_layout_set_width(layout, -1);
-	pango_layout_set_ellipsize(layout, PANGO_ELLIPSIZE_MIDDLE);
-	pango_layout_get_extents(layout, NULL, &rect);
-	pango_extents_to_pixels(&rect, NULL);
+	struct font_desc *font_desc = font_desc_get(font);
+	uint32_t hash = font_extents_hash(font_desc, string);
+	struct font_extents_entry **bucket =
+		&font_cache.buckets[hash & (FONT_CACHE_BUCKETS - 1)];
+	for (struct font_extents_entry *entry = *bucket; entry;
+			entry = entry->next) {
+		if (entry->hash == hash && entry->font == font_desc
+				&& !strcmp(entry->text, string)) {
+			font_cache.stats.hits++;
+			wl_list_remove(&entry->link);
+			wl_list_insert(&font_cache.lru, &entry->link);
+			return entry->rect;
+		}
+	}
+	font_cache.stats.misses++;
+
+	rect = font_extents_measure(font_desc, string);
 
 	/* we put a 2 px edge on each side - because Openbox does it :) */
 	/* TODO: remove the 4 pixel addition and always do the padding by the caller */
 	rect.width += 4;
 
-	cairo_destroy(c);
-	cairo_surface_destroy(surface);
-	pango_font_description_free(desc);
-	g_object_unref(layout);
+	if (font_cache.nr_entries >= FONT_CACHE_MAX_ENTRIES) {
+		struct font_extents_entry *oldest = wl_container_of(
+			font_cache.lru.prev, oldest, link);
+		font_extents_entry_destroy(oldest);
+		font_cache.stats.evictions++;
+	}
+
+	struct font_extents_entry *entry = znew(*entry);
+	entry->font = font_desc;
+	entry->text = xstrdup(string);
+	entry->hash = hash;
+	entry->rect = rect;
+	entry->next = *bucket;
+	*bucket = entry;
+	wl_list_insert(&font_cache.lru, &entry->link);
+	font_cache.nr_entries++;
 	return rect;
 }
 
@@ -120,10 +260,7 @@ font_buffer_create(struct lab_data_buffer **buffer, int max_width,
 	pango_layout_set_width(layout, text_extents.width * PANGO_SCALE);
 	pango_layout_set_text(layout, text, -1);
 	pango_layout_set_ellipsize(layout, PANGO_ELLIPSIZE_END);
-
-	PangoFontDescription *desc = font_to_pango_desc(font);
-	pango_layout_set_font_description(layout, desc);
-	pango_font_description_free(desc);
+	pango_layout_set_font_description(layout, font_desc_get(font)->desc);
 	pango_cairo_update_layout(cairo, layout);
 	pango_cairo_show_layout(cairo, layout);
 
@@ -139,8 +276,36 @@ font_buffer_create(struct lab_data_buffer **buffer, int max_width,
 	cairo_surface_flush(surf);
 }
 
+void
+font_cache_get_stats(struct font_cache_stats *stats)
+{
+	*stats = font_cache.stats;
+	stats->entries = font_cache.nr_entries;
+}
+
 void
 font_finish(void)
 {
+	if (font_cache.fonts.next) {
+		struct font_extents_entry *entry, *entry_tmp;
+		wl_list_for_each_safe(entry, entry_tmp, &font_cache.lru, link) {
+			font_extents_entry_destroy(entry);
+		}
+		struct font_desc *font_desc, *font_desc_tmp;
+		wl_list_for_each_safe(font_desc, font_desc_tmp,
+				&font_cache.fonts, link) {
+			wl_list_remove(&font_desc->link);
+			pango_font_description_free(font_desc->desc);
+			free(font_desc->name);
+			free(font_desc);
+		}
+	}
+	if (font_cache.layout) {
+		g_object_unref(font_cache.layout);
+		cairo_destroy(font_cache.cairo);
+		cairo_surface_destroy(font_cache.surface);
+	}
+	memset(&font_cache, 0, sizeof(font_cache));
+
 	pango_cairo_font_map_set_default(NULL);
 }
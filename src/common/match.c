@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
 #include <fnmatch.h>
+#include <string.h>
+#include <strings.h>
 #include "common/match.h"
 
 bool
@@ -8,3 +10,45 @@ match_glob(const char *pattern, const char *string)
 {
 	return fnmatch(pattern, string, FNM_CASEFOLD) == 0;
 }
+
+void
+glob_pattern_init(struct glob_pattern *glob, const char *pattern)
+{
+	glob->type = LAB_GLOB_FNMATCH;
+	glob->pattern = pattern;
+	glob->len = 0;
+	if (!pattern) {
+		return;
+	}
+
+	size_t len = strcspn(pattern, "*?[\\");
+	for (size_t i = 0; i < len; i++) {
+		/* Leave case folding of multibyte characters to fnmatch() */
+		if ((unsigned char)pattern[i] >= 0x80) {
+			return;
+		}
+	}
+	if (pattern[len] == '\0') {
+		glob->type = LAB_GLOB_LITERAL;
+	} else if (pattern[len] == '*' && pattern[len + 1] == '\0') {
+		glob->type = len ? LAB_GLOB_PREFIX : LAB_GLOB_ANY;
+	} else {
+		return;
+	}
+	glob->len = len;
+}
+
+bool
+glob_pattern_match(const struct glob_pattern *glob, const char *string)
+{
+	switch (glob->type) {
+	case LAB_GLOB_ANY:
+		return true;
+	case LAB_GLOB_LITERAL:
+		return !strcasecmp(glob->pattern, string);
+	case LAB_GLOB_PREFIX:
+		return !strncasecmp(glob->pattern, string, glob->len);
+	default:
+		return match_glob(glob->pattern, string);
+	}
+}
@@ -1,18 +1,29 @@
 // SPDX-License-Identifier: GPL-2.0-only
-#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
 #include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <glib.h>
 #include <signal.h>
+#include <spawn.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/wait.h>
 #include <unistd.h>
+#include <wayland-util.h>
 #include <wlr/util/log.h>
 #include "common/spawn.h"
 #include "common/fd_util.h"
 
-void
-spawn_async_no_shell(char const *command)
+/* Children which have not been reaped yet */
+static struct {
+	struct wl_array pids; /* pid_t */
+	struct spawn_stats stats;
+} children;
+
+char **
+spawn_parse_argv(const char *command)
 {
 	GError *err = NULL;
 	gchar **argv = NULL;
@@ -24,42 +35,185 @@ spawn_async_no_shell(char const *command)
 	if (err) {
 		g_message("%s", err->message);
 		g_error_free(err);
+		return NULL;
+	}
+	return argv;
+}
+
+void
+spawn_argv_free(char **argv)
+{
+	g_strfreev(argv);
+}
+
+void
+spawn_async_no_shell(char const *command)
+{
+	char **argv = spawn_parse_argv(command);
+	if (!argv) {
 		return;
 	}
+	spawn_async_argv(argv);
+	g_strfreev(argv);
+}
+
+/*
+ * posix_spawn() uses vfork() semantics, so the page tables of the
+ * compositor are not copied and the parent only waits for the exec.
+ */
+static pid_t
+spawn_child(char **argv, posix_spawn_file_actions_t *actions)
+{
+	posix_spawnattr_t attr;
+	posix_spawnattr_init(&attr);
+
+	/* Start with an empty signal mask and restore ignored signals */
+	sigset_t set;
+	sigemptyset(&set);
+	posix_spawnattr_setsigmask(&attr, &set);
+	sigaddset(&set, SIGPIPE);
+	posix_spawnattr_setsigdefault(&attr, &set);
+	posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSID
+		| POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
 
 	/*
-	 * Avoid zombie processes by using a double-fork, whereby the
-	 * grandchild becomes orphaned & the responsibility of the OS.
+	 * No code of ours runs in the child, so its open files limit can
+	 * not be lowered before the exec. On Linux it is lowered right
+	 * after with prlimit(). Until then the child runs with the raised
+	 * limit, which only matters to programs that select() on a
+	 * descriptor above FD_SETSIZE in their first instructions.
+	 *
+	 * Elsewhere the limit of the compositor is lowered around the
+	 * spawn instead. That limit is process-wide, so other threads
+	 * may briefly fail to open files with EMFILE.
 	 */
-	pid_t child = 0, grandchild = 0;
-
-	child = fork();
-	switch (child) {
-	case -1:
-		wlr_log(WLR_ERROR, "unable to fork()");
-		goto out;
-	case 0:
-		restore_nofile_limit();
-
-		setsid();
-		sigset_t set;
-		sigemptyset(&set);
-		sigprocmask(SIG_SETMASK, &set, NULL);
-		/* Restore ignored signals */
-		signal(SIGPIPE, SIG_DFL);
-		grandchild = fork();
-		if (grandchild == 0) {
-			execvp(argv[0], argv);
-			_exit(0);
-		} else if (grandchild < 0) {
-			wlr_log(WLR_ERROR, "unable to fork()");
+	pid_t pid;
+#ifdef __linux__
+	int err = posix_spawnp(&pid, argv[0], actions, &attr, argv, environ);
+	if (!err) {
+		restore_nofile_limit_of(pid);
+	}
+#else
+	bool restored = restore_nofile_limit();
+	int err = posix_spawnp(&pid, argv[0], actions, &attr, argv, environ);
+	if (restored) {
+		increase_nofile_limit();
+	}
+#endif
+	posix_spawnattr_destroy(&attr);
+
+	if (err) {
+		wlr_log(WLR_ERROR, "unable to spawn %s: %s", argv[0],
+			strerror(err));
+		return -1;
+	}
+	children.stats.spawned++;
+	return pid;
+}
+
+void
+spawn_async_argv(char **argv)
+{
+	assert(argv && argv[0]);
+
+	pid_t pid = spawn_child(argv, NULL);
+	if (pid > 0) {
+		spawn_reap_async(pid);
+	}
+}
+
+pid_t
+spawn_piped(const char *command, int *pipe_fd)
+{
+	char **argv = spawn_parse_argv(command);
+	if (!argv) {
+		return -1;
+	}
+
+	int fds[2];
+	if (pipe(fds) < 0) {
+		wlr_log_errno(WLR_ERROR, "unable to create pipe");
+		spawn_argv_free(argv);
+		return -1;
+	}
+	/* Keep the pipe out of other children, dup2() clears the flag */
+	fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+	fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+	pid_t child = spawn_child(argv, &actions);
+	posix_spawn_file_actions_destroy(&actions);
+
+	close(fds[1]);
+	spawn_argv_free(argv);
+	if (child < 0) {
+		close(fds[0]);
+		return -1;
+	}
+	fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+	*pipe_fd = fds[0];
+	return child;
+}
+
+/* Returns true if @pid has been reaped or does not need to be anymore */
+static bool
+reap(pid_t pid)
+{
+	pid_t ret = waitpid(pid, NULL, WNOHANG);
+	if (ret == 0 || (ret < 0 && errno == EINTR)) {
+		return false;
+	}
+	children.stats.reaped++;
+	return true;
+}
+
+void
+spawn_reap_async(pid_t pid)
+{
+	/* It may have exited already, then no SIGCHLD is going to follow */
+	if (reap(pid)) {
+		return;
+	}
+	pid_t *slot = wl_array_add(&children.pids, sizeof(pid));
+	if (!slot) {
+		wlr_log(WLR_ERROR, "unable to track child %d", (int)pid);
+		return;
+	}
+	*slot = pid;
+}
+
+void
+spawn_reap_children(void)
+{
+	/*
+	 * Only wait for our own children, others like Xwayland are waited
+	 * for by whoever started them. Swap-remove whatever has exited.
+	 */
+	pid_t *pids = children.pids.data;
+	size_t nr = children.pids.size / sizeof(pid_t);
+	for (size_t i = 0; i < nr; ) {
+		if (reap(pids[i])) {
+			pids[i] = pids[--nr];
+		} else {
+			i++;
 		}
-		_exit(0);
-	default:
-		break;
 	}
-	waitpid(child, NULL, 0);
-out:
-	g_strfreev(argv);
+	children.pids.size = nr * sizeof(pid_t);
+}
+
+void
+spawn_get_stats(struct spawn_stats *stats)
+{
+	*stats = children.stats;
+	stats->pending = children.pids.size / sizeof(pid_t);
 }
 
+void
+spawn_finish(void)
+{
+	/* Whatever is still running gets re-parented once we exit */
+	wl_array_release(&children.pids);
+	wl_array_init(&children.pids);
+}
@@ -6,12 +6,138 @@
 #include <stdlib.h>
 #include <string.h>
 #include <wlr/util/log.h>
+#include "action.h"
 #include "common/list.h"
 #include "common/mem.h"
 #include "config/keybind.h"
 #include "config/rcxml.h"
 #include "labwc.h"
 
+/*
+ * Open addressing hash table with linear probing over all (modifiers,
+ * keycode) and (modifiers, keysym) pairs of rc.keybinds. Entries are added
+ * in list order and never removed, so entries with the same key are found
+ * in list order too, which keeps the first-configured-wins semantics of the
+ * old linear scan.
+ */
+struct keybind_index_entry {
+	uint64_t key;
+	struct keybind *keybind;
+	bool toggles_keybinds;
+};
+
+static struct {
+	struct keybind_index_entry *entries;
+	size_t size; /* power of two, 0 if not built */
+} keybind_index;
+
+static uint64_t
+index_key(uint32_t modifiers, uint32_t code, bool is_sym)
+{
+	return ((uint64_t)modifiers << 33) | ((uint64_t)is_sym << 32) | code;
+}
+
+/* 64-bit finalizer of MurmurHash3 */
+static size_t
+index_hash(uint64_t key)
+{
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53ULL;
+	key ^= key >> 33;
+	return key;
+}
+
+static void
+index_insert(uint64_t key, struct keybind *keybind, bool toggles_keybinds)
+{
+	size_t mask = keybind_index.size - 1;
+	size_t i = index_hash(key) & mask;
+	while (keybind_index.entries[i].keybind) {
+		i = (i + 1) & mask;
+	}
+	keybind_index.entries[i] = (struct keybind_index_entry){
+		.key = key,
+		.keybind = keybind,
+		.toggles_keybinds = toggles_keybinds,
+	};
+}
+
+static struct keybind *
+index_lookup(uint64_t key, bool toggle_only)
+{
+	if (!keybind_index.size) {
+		return NULL;
+	}
+	size_t mask = keybind_index.size - 1;
+	for (size_t i = index_hash(key) & mask; ; i = (i + 1) & mask) {
+		struct keybind_index_entry *entry = &keybind_index.entries[i];
+		if (!entry->keybind) {
+			return NULL;
+		}
+		if (entry->key == key
+				&& (!toggle_only || entry->toggles_keybinds)) {
+			return entry->keybind;
+		}
+	}
+}
+
+void
+keybind_index_finish(void)
+{
+	zfree(keybind_index.entries);
+	keybind_index.size = 0;
+}
+
+static void
+keybind_index_build(void)
+{
+	keybind_index_finish();
+
+	size_t nr_entries = 0;
+	struct keybind *keybind;
+	wl_list_for_each(keybind, &rc.keybinds, link) {
+		nr_entries += keybind->keycodes_len + keybind->keysyms_len;
+	}
+
+	/* Keep the load factor at or below 50% */
+	size_t size = 16;
+	while (size < nr_entries * 2) {
+		size *= 2;
+	}
+	keybind_index.entries = znew_n(*keybind_index.entries, size);
+	keybind_index.size = size;
+
+	wl_list_for_each(keybind, &rc.keybinds, link) {
+		bool toggles = actions_contain_toggle_keybinds(&keybind->actions);
+		for (size_t i = 0; i < keybind->keycodes_len; i++) {
+			index_insert(index_key(keybind->modifiers,
+				keybind->keycodes[i], false), keybind, toggles);
+		}
+		for (size_t i = 0; i < keybind->keysyms_len; i++) {
+			index_insert(index_key(keybind->modifiers,
+				keybind->keysyms[i], true), keybind, toggles);
+		}
+	}
+	wlr_log(WLR_DEBUG, "indexed %zu keybind keys", nr_entries);
+}
+
+struct keybind *
+keybind_find_by_keycode(uint32_t modifiers, xkb_keycode_t keycode,
+		bool toggle_only)
+{
+	return index_lookup(index_key(modifiers, keycode, false), toggle_only);
+}
+
+struct keybind *
+keybind_find_by_sym(uint32_t modifiers, xkb_keysym_t sym, bool toggle_only)
+{
+	/* Keybind keysyms are stored in lower case by keybind_create() */
+	return index_lookup(index_key(modifiers, xkb_keysym_to_lower(sym), true),
+		toggle_only);
+}
+
 uint32_t
 parse_modifier(const char *symname)
 {
@@ -113,6 +239,7 @@ keybind_update_keycodes(struct server *server)
 		wlr_log(WLR_DEBUG, "Found layout %s", xkb_keymap_layout_get_name(keymap, i));
 		xkb_keymap_key_for_each(keymap, update_keycodes_iter, &i);
 	}
+	keybind_index_build();
 }
 
 struct keybind *
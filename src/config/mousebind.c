@@ -10,6 +10,23 @@
 #include "config/mousebind.h"
 #include "config/rcxml.h"
 
+struct mousebind_index_entry {
+	uint64_t key;
+	struct mousebind *mousebind;
+};
+
+struct mousebind_index {
+	struct mousebind_index_entry *entries;
+	struct mousebind **mousebinds; /* same order as entries */
+	size_t len;
+};
+
+static struct mousebind_index button_index;
+static struct mousebind_index direction_index;
+
+/* Armed click and drag mousebinds, in the order they were pressed */
+static struct wl_list pressed = { &pressed, &pressed };
+
 uint32_t
 mousebind_button_from_str(const char *str, uint32_t *modifiers)
 {
@@ -156,6 +173,7 @@ mousebind_create(const char *context)
 		return NULL;
 	}
 	struct mousebind *m = znew(*m);
+	wl_list_init(&m->pressed_link);
 	m->context = context_from_str(context);
 	if (m->context != LAB_SSD_NONE) {
 		wl_list_append(&rc.mousebinds, &m->link);
@@ -163,3 +181,158 @@ mousebind_create(const char *context)
 	wl_list_init(&m->actions);
 	return m;
 }
+
+static uint64_t
+index_key(uint32_t modifiers, uint32_t code)
+{
+	return ((uint64_t)modifiers << 32) | code;
+}
+
+static void
+index_finish(struct mousebind_index *index)
+{
+	zfree(index->entries);
+	zfree(index->mousebinds);
+	index->len = 0;
+}
+
+static void
+index_add(struct mousebind_index *index, uint64_t key,
+		struct mousebind *mousebind)
+{
+	/* Insertion sort, keeping rc.xml order for equal keys */
+	size_t i = index->len++;
+	while (i > 0 && index->entries[i - 1].key > key) {
+		index->entries[i] = index->entries[i - 1];
+		i--;
+	}
+	index->entries[i].key = key;
+	index->entries[i].mousebind = mousebind;
+}
+
+static void
+index_sync_mousebinds(struct mousebind_index *index)
+{
+	for (size_t i = 0; i < index->len; i++) {
+		index->mousebinds[i] = index->entries[i].mousebind;
+	}
+}
+
+static struct mousebind_match
+index_find(struct mousebind_index *index, uint64_t key)
+{
+	/* Find the first entry with a key not less than key */
+	size_t lo = 0, hi = index->len;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (index->entries[mid].key < key) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	struct mousebind_match match = { .mousebinds = NULL, .count = 0 };
+	while (lo + match.count < index->len
+			&& index->entries[lo + match.count].key == key) {
+		match.count++;
+	}
+	if (match.count) {
+		match.mousebinds = &index->mousebinds[lo];
+	}
+	return match;
+}
+
+void
+mousebind_index_build(void)
+{
+	mousebind_index_finish();
+
+	size_t len = wl_list_length(&rc.mousebinds);
+	if (!len) {
+		return;
+	}
+	button_index.entries = znew_n(*button_index.entries, len);
+	button_index.mousebinds = znew_n(*button_index.mousebinds, len);
+	direction_index.entries = znew_n(*direction_index.entries, len);
+	direction_index.mousebinds = znew_n(*direction_index.mousebinds, len);
+
+	struct mousebind *mousebind;
+	wl_list_for_each(mousebind, &rc.mousebinds, link) {
+		wl_list_init(&mousebind->pressed_link);
+		if (mousebind->mouse_event == MOUSE_ACTION_SCROLL) {
+			index_add(&direction_index, index_key(mousebind->modifiers,
+				mousebind->direction), mousebind);
+		} else {
+			index_add(&button_index, index_key(mousebind->modifiers,
+				mousebind->button), mousebind);
+		}
+	}
+	index_sync_mousebinds(&button_index);
+	index_sync_mousebinds(&direction_index);
+	wlr_log(WLR_DEBUG, "indexed %zu button and %zu scroll mousebinds",
+		button_index.len, direction_index.len);
+}
+
+void
+mousebind_index_finish(void)
+{
+	index_finish(&button_index);
+	index_finish(&direction_index);
+	/* The mousebinds are about to be freed */
+	struct mousebind *mousebind, *tmp;
+	wl_list_for_each_safe(mousebind, tmp, &pressed, pressed_link) {
+		wl_list_remove(&mousebind->pressed_link);
+		wl_list_init(&mousebind->pressed_link);
+		mousebind->pressed_in_context = false;
+	}
+}
+
+struct mousebind_match
+mousebind_find_by_button(uint32_t modifiers, uint32_t button)
+{
+	return index_find(&button_index, index_key(modifiers, button));
+}
+
+struct mousebind_match
+mousebind_find_by_direction(uint32_t modifiers, enum direction direction)
+{
+	return index_find(&direction_index, index_key(modifiers, direction));
+}
+
+void
+mousebind_set_pressed(struct mousebind *mousebind)
+{
+	if (mousebind->pressed_in_context) {
+		return;
+	}
+	mousebind->pressed_in_context = true;
+	wl_list_append(&pressed, &mousebind->pressed_link);
+}
+
+void
+mousebind_clear_pressed(uint32_t button)
+{
+	struct mousebind *mousebind, *tmp;
+	wl_list_for_each_safe(mousebind, tmp, &pressed, pressed_link) {
+		if (mousebind->button == button) {
+			wl_list_remove(&mousebind->pressed_link);
+			wl_list_init(&mousebind->pressed_link);
+			mousebind->pressed_in_context = false;
+		}
+	}
+}
+
+struct mousebind *
+mousebind_take_pressed_drag(void)
+{
+	struct mousebind *mousebind;
+	wl_list_for_each(mousebind, &pressed, pressed_link) {
+		if (mousebind->mouse_event == MOUSE_ACTION_DRAG) {
+			wl_list_remove(&mousebind->pressed_link);
+			wl_list_init(&mousebind->pressed_link);
+			mousebind->pressed_in_context = false;
+			return mousebind;
+		}
+	}
+	return NULL;
+}
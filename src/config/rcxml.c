@@ -133,9 +133,13 @@ fill_window_rule(char *nodename, char *content)
 	} else if (!strcmp(nodename, "identifier")) {
 		free(current_window_rule->identifier);
 		current_window_rule->identifier = xstrdup(content);
+		glob_pattern_init(&current_window_rule->identifier_glob,
+			current_window_rule->identifier);
 	} else if (!strcmp(nodename, "title")) {
 		free(current_window_rule->title);
 		current_window_rule->title = xstrdup(content);
+		glob_pattern_init(&current_window_rule->title_glob,
+			current_window_rule->title);
 	} else if (!strcasecmp(nodename, "matchOnce")) {
 		set_bool(content, &current_window_rule->match_once);
 
@@ -271,19 +275,25 @@ fill_action_query(char *nodename, char *content, struct action *action)
 	}
 
 	if (!current_view_query) {
-		struct wl_list *queries = action_get_querylist(action, "query");
+		struct wl_list *queries = action_get_querylist(action);
 		if (!queries) {
-			action_arg_add_querylist(action, "query");
-			queries = action_get_querylist(action, "query");
+			wlr_log(WLR_ERROR, "<query> is only supported by If and ForEach");
+			return;
 		}
 		current_view_query = znew(*current_view_query);
 		wl_list_append(queries, &current_view_query->link);
 	}
 
 	if (!strcasecmp(nodename, "identifier")) {
+		free(current_view_query->identifier);
 		current_view_query->identifier = xstrdup(content);
+		glob_pattern_init(&current_view_query->identifier_glob,
+			current_view_query->identifier);
 	} else if (!strcasecmp(nodename, "title")) {
+		free(current_view_query->title);
 		current_view_query->title = xstrdup(content);
+		glob_pattern_init(&current_view_query->title_glob,
+			current_view_query->title);
 	}
 }
 
@@ -306,8 +316,9 @@ fill_child_action(char *nodename, char *content, struct action *parent,
 
 	struct wl_list *siblings = action_get_actionlist(parent, branch_name);
 	if (!siblings) {
-		action_arg_add_actionlist(parent, branch_name);
-		siblings = action_get_actionlist(parent, branch_name);
+		wlr_log(WLR_ERROR, "<%s> is only supported by If and ForEach",
+			branch_name);
+		return;
 	}
 
 	if (!strcasecmp(nodename, "name.action")) {
@@ -703,6 +714,12 @@ entry(xmlNode *node, char *nodename, char *content)
 		set_bool(content, &rc.adaptive_sync);
 	} else if (!strcasecmp(nodename, "reuseOutputMode.core")) {
 		set_bool(content, &rc.reuse_output_mode);
+	} else if (!strcasecmp(nodename, "titleUpdateInterval.core")) {
+		rc.title_update_interval = MAX(atoi(content), 0);
+	} else if (!strcasecmp(nodename, "releaseTimeout.menu")) {
+		rc.menu_release_timeout = MAX(atoi(content), 0);
+	} else if (!strcasecmp(nodename, "pipemenuCacheTime.menu")) {
+		rc.menu_pipemenu_cache_time = MAX(atoi(content), 0);
 	} else if (!strcmp(nodename, "name.theme")) {
 		rc.theme_name = xstrdup(content);
 	} else if (!strcmp(nodename, "cornerradius.theme")) {
@@ -732,6 +749,8 @@ entry(xmlNode *node, char *nodename, char *content)
 		}
 	} else if (!strcasecmp(nodename, "scrollFactor.mouse")) {
 		rc.scroll_factor = atof(content);
+	} else if (!strcasecmp(nodename, "coalesceMotion.mouse")) {
+		set_bool(content, &rc.coalesce_motion);
 	} else if (!strcasecmp(nodename, "name.context.mouse")) {
 		current_mouse_context = content;
 		current_mousebind = NULL;
@@ -750,6 +769,8 @@ entry(xmlNode *node, char *nodename, char *content)
 		rc.kb_layout_per_window = !strcasecmp(content, "window");
 	} else if (!strcasecmp(nodename, "screenEdgeStrength.resistance")) {
 		rc.screen_edge_strength = atoi(content);
+	} else if (!strcasecmp(nodename, "windowEdgeStrength.resistance")) {
+		rc.window_edge_strength = atoi(content);
 	} else if (!strcasecmp(nodename, "range.snapping")) {
 		rc.snap_edge_range = atoi(content);
 	} else if (!strcasecmp(nodename, "topMaximize.snapping")) {
@@ -910,6 +931,51 @@ xml_tree_walk(xmlNode *node)
 	}
 }
 
+static const char *const section_names[RC_SECTION_COUNT] = {
+	[RC_SECTION_KEYBOARD] = "keyboard",
+	[RC_SECTION_WINDOW_RULES] = "windowRules",
+	[RC_SECTION_LIBINPUT] = "libinput",
+	[RC_SECTION_THEME] = "theme",
+	[RC_SECTION_REGIONS] = "regions",
+};
+
+/* 64-bit FNV-1a */
+static uint64_t
+digest_update(uint64_t digest, const unsigned char *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		digest ^= data[i];
+		digest *= 0x100000001b3;
+	}
+	return digest;
+}
+
+/*
+ * Hash the serialized top-level sections so that a reconfigure can tell
+ * which of them changed without comparing the parsed structures.
+ */
+static void
+digest_sections(xmlNode *root)
+{
+	for (xmlNode *n = root ? root->children : NULL; n; n = n->next) {
+		if (n->type != XML_ELEMENT_NODE) {
+			continue;
+		}
+		for (size_t i = 0; i < RC_SECTION_COUNT; i++) {
+			if (strcasecmp((char *)n->name, section_names[i])) {
+				continue;
+			}
+			xmlBuffer *buf = xmlBufferCreate();
+			xmlNodeDump(buf, n->doc, n, 0, 0);
+			uint64_t digest = rc.section_digest[i]
+				? rc.section_digest[i] : 0xcbf29ce484222325;
+			rc.section_digest[i] = digest_update(digest,
+				xmlBufferContent(buf), xmlBufferLength(buf));
+			xmlBufferFree(buf);
+		}
+	}
+}
+
 /* Exposed in header file to allow unit tests to parse buffers */
 void
 rcxml_parse_xml(struct buf *b)
@@ -920,6 +986,7 @@ rcxml_parse_xml(struct buf *b)
 		return;
 	}
 	xml_tree_walk(xmlDocGetRootElement(d));
+	digest_sections(xmlDocGetRootElement(d));
 	xmlFreeDoc(d);
 	xmlCleanupParser();
 }
@@ -949,6 +1016,7 @@ rcxml_init(void)
 	}
 	has_run = true;
 
+	memset(rc.section_digest, 0, sizeof(rc.section_digest));
 	rc.xdg_shell_server_side_deco = true;
 	rc.ssd_keep_border = true;
 	rc.corner_radius = 8;
@@ -969,6 +1037,7 @@ rcxml_init(void)
 	rc.kb_numlock_enable = true;
 	rc.kb_layout_per_window = false;
 	rc.screen_edge_strength = 20;
+	rc.window_edge_strength = 20;
 
 	rc.snap_edge_range = 1;
 	rc.snap_top_maximize = true;
@@ -978,6 +1047,8 @@ rcxml_init(void)
 	rc.window_switcher.outlines = true;
 
 	rc.resize_indicator = LAB_RESIZE_INDICATOR_NEVER;
+	rc.menu_release_timeout = 0;
+	rc.menu_pipemenu_cache_time = 0;
 
 	rc.workspace_config.popuptime = INT_MIN;
 	rc.workspace_config.min_nr_workspaces = 1;
@@ -1443,6 +1514,7 @@ rcxml_read(const char *filename)
 no_config:
 	post_processing();
 	validate();
+	mousebind_index_build();
 }
 
 void
@@ -1461,6 +1533,8 @@ rcxml_finish(void)
 		zfree(area);
 	}
 
+	keybind_index_finish();
+	mousebind_index_finish();
 	struct keybind *k, *k_tmp;
 	wl_list_for_each_safe(k, k_tmp, &rc.keybinds, link) {
 		wl_list_remove(&k->link);
@@ -7,6 +7,7 @@
 #include "layers.h"
 #include "node.h"
 #include "ssd.h"
+#include "trace.h"
 #include "view.h"
 #include "window-rules.h"
 #include "workspaces.h"
@@ -37,6 +38,18 @@ desktop_arrange_all_views(struct server *server)
 	}
 }
 
+/* Like desktop_arrange_all_views() but only for views on @output */
+void
+desktop_arrange_output_views(struct output *output)
+{
+	struct view *view, *tmp;
+	wl_list_for_each_safe(view, tmp, &output->views, output_link) {
+		if (!wlr_box_empty(&view->pending)) {
+			view_adjust_for_layout_change(view);
+		}
+	}
+}
+
 void
 desktop_focus_view(struct view *view, bool raise)
 {
@@ -201,7 +214,8 @@ desktop_cycle_view(struct server *server, struct view *start_view,
 		}
 		view = node_view_from_node(node);
 
-		enum property skip = window_rules_get_property(view, "skipWindowSwitcher");
+		enum property skip = window_rules_get_property(view,
+			LAB_RULE_PROP_SKIP_WINDOW_SWITCHER);
 		if (view_is_focusable(view) && skip != LAB_PROP_TRUE) {
 			return view;
 		}
@@ -304,10 +318,9 @@ desktop_update_top_layer_visiblity(struct server *server)
 	}
 
 	/* And disable them again when there is a view in fullscreen */
-	enum lab_view_criteria criteria =
-		LAB_VIEW_CRITERIA_CURRENT_WORKSPACE | LAB_VIEW_CRITERIA_FULLSCREEN;
-	for_each_view(view, &server->views, criteria) {
-		if (!output_is_usable(view->output)) {
+	for_each_view_on_workspace(view, server->workspace_current) {
+		if (!view_matches_criteria(view, LAB_VIEW_CRITERIA_FULLSCREEN)
+				|| !output_is_usable(view->output)) {
 			continue;
 		}
 		wlr_scene_node_set_enabled(&view->output->layer_tree[top]->node, false);
@@ -346,10 +359,59 @@ start:
 	return false;
 }
 
+/*
+ * Like wlr_scene_node_at() but skips the subtrees of views which do not
+ * contain the point according to view->bounds. With many views this saves
+ * walking the client surface and decoration nodes of most of them.
+ * Overlays are skipped altogether so that input reaches what is below.
+ */
+static struct wlr_scene_node *
+scene_node_at(struct wlr_scene_node *node, double lx, double ly,
+		double *nx, double *ny)
+{
+	if (!node->enabled) {
+		return NULL;
+	}
+	if (node->type != WLR_SCENE_NODE_TREE) {
+		return wlr_scene_node_at(node, lx, ly, nx, ny);
+	}
+
+	struct node_descriptor *desc = node->data;
+	if (desc && desc->type == LAB_NODE_DESC_OVERLAY) {
+		return NULL;
+	}
+	if (desc && desc->type == LAB_NODE_DESC_VIEW) {
+		struct view *view = desc->data;
+		if (!wlr_box_contains_point(&view->bounds, lx, ly)) {
+			return NULL;
+		}
+		return wlr_scene_node_at(node, lx, ly, nx, ny);
+	}
+
+	struct wlr_scene_tree *tree = wlr_scene_tree_from_node(node);
+	struct wlr_scene_node *child;
+	wl_list_for_each_reverse(child, &tree->children, link) {
+		struct wlr_scene_node *found =
+			scene_node_at(child, lx, ly, nx, ny);
+		if (found) {
+			return found;
+		}
+	}
+	return NULL;
+}
+
+struct wlr_scene_node *
+desktop_node_at(struct server *server, double lx, double ly,
+		double *sx, double *sy)
+{
+	return scene_node_at(&server->scene->tree.node, lx, ly, sx, sy);
+}
+
 /* TODO: make this less big and scary */
 struct cursor_context
 get_cursor_context(struct server *server)
 {
+	TRACE_SCOPE("get_cursor_context");
 	struct cursor_context ret = {.type = LAB_SSD_NONE};
 	struct wlr_cursor *cursor = server->seat.cursor;
 
@@ -358,9 +420,8 @@ get_cursor_context(struct server *server)
 		dnd_icons_show(&server->seat, false);
 	}
 
-	struct wlr_scene_node *node =
-		wlr_scene_node_at(&server->scene->tree.node,
-			cursor->x, cursor->y, &ret.sx, &ret.sy);
+	struct wlr_scene_node *node = desktop_node_at(server,
+		cursor->x, cursor->y, &ret.sx, &ret.sy);
 
 	if (server->seat.drag.active) {
 		dnd_icons_show(&server->seat, true);
@@ -423,6 +484,7 @@ get_cursor_context(struct server *server)
 				return ret;
 			case LAB_NODE_DESC_NODE:
 			case LAB_NODE_DESC_TREE:
+			case LAB_NODE_DESC_OVERLAY:
 				break;
 			}
 		}
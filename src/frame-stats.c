@@ -0,0 +1,332 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
+#include <inttypes.h>
+#include <pixman.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <wlr/types/wlr_damage_ring.h>
+#include <wlr/types/wlr_output_layout.h>
+#include <wlr/types/wlr_scene.h>
+#include <wlr/util/log.h>
+#include "common/macros.h"
+#include "common/scaled_font_buffer.h"
+#include "frame-stats.h"
+#include "labwc.h"
+#include "node.h"
+#include "theme.h"
+
+#define OVERLAY_INTERVAL_MS 500
+#define HISTOGRAM_BAR_WIDTH 40
+
+struct bucket {
+	uint32_t max;
+	const char *label;
+};
+
+static const struct bucket commit_buckets[] = {
+	{ 99, "< 0.1 ms" },
+	{ 249, "< 0.25 ms" },
+	{ 499, "< 0.5 ms" },
+	{ 999, "< 1 ms" },
+	{ 1999, "< 2 ms" },
+	{ 3999, "< 4 ms" },
+	{ 7999, "< 8 ms" },
+	{ 15999, "< 16 ms" },
+	{ UINT32_MAX, ">= 16 ms" },
+};
+
+/* In permille, the last bucket only holds full repaints */
+static const struct bucket damage_buckets[] = {
+	{ 9, "< 1%" },
+	{ 49, "< 5%" },
+	{ 99, "< 10%" },
+	{ 249, "< 25%" },
+	{ 499, "< 50%" },
+	{ 749, "< 75%" },
+	{ 999, "< 100%" },
+	{ 1000, "100%" },
+};
+
+static bool overlay_enabled;
+
+uint64_t
+frame_stats_now(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+int
+frame_stats_damage(struct wlr_scene_output *scene_output)
+{
+	struct wlr_damage_ring *ring = &scene_output->damage_ring;
+	uint64_t total = (uint64_t)ring->width * ring->height;
+	if (!total) {
+		return 0;
+	}
+
+	/* The damage ring clips to the buffer and never overlaps rectangles */
+	int nr_rects;
+	pixman_box32_t *rects =
+		pixman_region32_rectangles(&ring->current, &nr_rects);
+	uint64_t area = 0;
+	for (int i = 0; i < nr_rects; i++) {
+		area += (uint64_t)(rects[i].x2 - rects[i].x1)
+			* (rects[i].y2 - rects[i].y1);
+	}
+	return MIN(area * 1000 / total, 1000);
+}
+
+void
+frame_stats_add(struct frame_stats *stats, uint64_t commit_nsec,
+		int damage_permille, bool success)
+{
+	if (!success) {
+		stats->failures++;
+	}
+	if (damage_permille == 1000) {
+		stats->full_damage++;
+	}
+	struct frame_sample *sample =
+		&stats->samples[stats->commits % FRAME_STATS_WINDOW];
+	sample->commit_usec = MIN(commit_nsec / 1000, UINT32_MAX);
+	sample->damage_permille = damage_permille;
+	stats->commits++;
+}
+
+static int
+compare_u32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+	return (x > y) - (x < y);
+}
+
+static uint32_t
+percentile(const uint32_t *sorted, uint32_t nr, uint32_t p)
+{
+	return sorted[(nr - 1) * p / 100];
+}
+
+void
+frame_stats_summarize(struct frame_stats *stats, struct frame_summary *summary)
+{
+	static uint32_t commit_usec[FRAME_STATS_WINDOW];
+	static uint32_t damage[FRAME_STATS_WINDOW];
+
+	memset(summary, 0, sizeof(*summary));
+	summary->nr_samples = MIN(stats->commits, FRAME_STATS_WINDOW);
+	if (!summary->nr_samples) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < summary->nr_samples; i++) {
+		commit_usec[i] = stats->samples[i].commit_usec;
+		damage[i] = stats->samples[i].damage_permille;
+		if (damage[i] == 1000) {
+			summary->full_damage++;
+		}
+	}
+	qsort(commit_usec, summary->nr_samples, sizeof(*commit_usec),
+		compare_u32);
+	qsort(damage, summary->nr_samples, sizeof(*damage), compare_u32);
+
+	summary->commit_usec_p50 =
+		percentile(commit_usec, summary->nr_samples, 50);
+	summary->commit_usec_p99 =
+		percentile(commit_usec, summary->nr_samples, 99);
+	summary->commit_usec_max = commit_usec[summary->nr_samples - 1];
+	summary->damage_permille_p50 =
+		percentile(damage, summary->nr_samples, 50);
+	summary->damage_permille_p99 =
+		percentile(damage, summary->nr_samples, 99);
+}
+
+static void
+print_histogram(const struct bucket *buckets, size_t nr_buckets,
+		const uint32_t *counts, uint32_t total)
+{
+	char bar[HISTOGRAM_BAR_WIDTH + 1];
+	for (size_t i = 0; i < nr_buckets; i++) {
+		int len = counts[i] * HISTOGRAM_BAR_WIDTH / total;
+		memset(bar, '#', len);
+		bar[len] = '\0';
+		printf("    %10s %6u  %s\n", buckets[i].label, counts[i], bar);
+	}
+}
+
+static size_t
+bucket_index(const struct bucket *buckets, size_t nr_buckets, uint32_t value)
+{
+	for (size_t i = 0; i < nr_buckets - 1; i++) {
+		if (value <= buckets[i].max) {
+			return i;
+		}
+	}
+	return nr_buckets - 1;
+}
+
+void
+frame_stats_dump(struct server *server)
+{
+	uint32_t commit_counts[ARRAY_SIZE(commit_buckets)];
+	uint32_t damage_counts[ARRAY_SIZE(damage_buckets)];
+
+	printf("\nframe statistics\n");
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		struct frame_stats *stats = &output->frame_stats;
+		printf("%s: %" PRIu64 " commits, %" PRIu64 " skipped, %" PRIu64
+			" gamma commits, %" PRIu64 " failed, %" PRIu64
+			" full repaints\n", output->wlr_output->name,
+			stats->commits, stats->skipped, stats->gamma_commits,
+			stats->failures, stats->full_damage);
+
+		uint32_t nr = MIN(stats->commits, FRAME_STATS_WINDOW);
+		if (!nr) {
+			continue;
+		}
+		memset(commit_counts, 0, sizeof(commit_counts));
+		memset(damage_counts, 0, sizeof(damage_counts));
+		for (uint32_t i = 0; i < nr; i++) {
+			struct frame_sample *sample = &stats->samples[i];
+			commit_counts[bucket_index(commit_buckets,
+				ARRAY_SIZE(commit_buckets),
+				sample->commit_usec)]++;
+			damage_counts[bucket_index(damage_buckets,
+				ARRAY_SIZE(damage_buckets),
+				sample->damage_permille)]++;
+		}
+		printf("  commit time, last %u commits\n", nr);
+		print_histogram(commit_buckets, ARRAY_SIZE(commit_buckets),
+			commit_counts, nr);
+		printf("  damaged area, last %u commits\n", nr);
+		print_histogram(damage_buckets, ARRAY_SIZE(damage_buckets),
+			damage_counts, nr);
+	}
+	printf("\n");
+	fflush(stdout);
+}
+
+static bool
+overlay_create(struct output *output)
+{
+	struct frame_stats *stats = &output->frame_stats;
+	struct theme *theme = output->server->theme;
+
+	stats->overlay.tree =
+		wlr_scene_tree_create(&output->server->scene->tree);
+	node_descriptor_create(&stats->overlay.tree->node,
+		LAB_NODE_DESC_OVERLAY, NULL);
+	/* Above everything but the lock screen */
+	wlr_scene_node_place_below(&stats->overlay.tree->node,
+		&output->session_lock_tree->node);
+
+	stats->overlay.background = wlr_scene_rect_create(stats->overlay.tree,
+		0, 0, theme->osd_bg_color);
+	for (size_t i = 0; i < ARRAY_SIZE(stats->overlay.lines); i++) {
+		stats->overlay.lines[i] =
+			scaled_font_buffer_create(stats->overlay.tree);
+		if (!stats->overlay.lines[i]) {
+			wlr_log(WLR_ERROR, "failed to create frame stats overlay");
+			frame_stats_overlay_destroy(output);
+			return false;
+		}
+	}
+	return true;
+}
+
+void
+frame_stats_overlay_update(struct output *output)
+{
+	struct frame_stats *stats = &output->frame_stats;
+	if (!overlay_enabled) {
+		return;
+	}
+	if (!stats->overlay.tree && !overlay_create(output)) {
+		return;
+	}
+
+	/*
+	 * The previous update causes one repaint by itself, which must not
+	 * keep the overlay (and the output) busy forever.
+	 */
+	uint64_t now = frame_stats_now() / 1000000;
+	if (stats->overlay.updated_msec
+			&& (now - stats->overlay.updated_msec < OVERLAY_INTERVAL_MS
+			|| stats->commits - stats->overlay.updated_commits <= 1)) {
+		return;
+	}
+	stats->overlay.updated_msec = now;
+	stats->overlay.updated_commits = stats->commits;
+
+	struct frame_summary summary;
+	frame_stats_summarize(stats, &summary);
+
+	char text[FRAME_STATS_OVERLAY_LINES][256];
+	snprintf(text[0], sizeof(text[0]), "%s: %" PRIu64 " commits, %" PRIu64
+		" skipped, %" PRIu64 " gamma, %" PRIu64 " failed",
+		output->wlr_output->name, stats->commits, stats->skipped,
+		stats->gamma_commits, stats->failures);
+	snprintf(text[1], sizeof(text[1]),
+		"commit: p50 %u us, p99 %u us, max %u us",
+		summary.commit_usec_p50, summary.commit_usec_p99,
+		summary.commit_usec_max);
+	snprintf(text[2], sizeof(text[2]),
+		"damage: p50 %u.%u%%, p99 %u.%u%%, full %u of %u",
+		summary.damage_permille_p50 / 10,
+		summary.damage_permille_p50 % 10,
+		summary.damage_permille_p99 / 10,
+		summary.damage_permille_p99 % 10,
+		summary.full_damage, summary.nr_samples);
+
+	struct wlr_box box;
+	wlr_output_layout_get_box(output->server->output_layout,
+		output->wlr_output, &box);
+	wlr_scene_node_set_position(&stats->overlay.tree->node, box.x, box.y);
+
+	struct theme *theme = output->server->theme;
+	int padding = theme->osd_window_switcher_padding;
+	int width = 0;
+	int y = padding;
+	for (size_t i = 0; i < ARRAY_SIZE(stats->overlay.lines); i++) {
+		struct scaled_font_buffer *line = stats->overlay.lines[i];
+		scaled_font_buffer_update(line, text[i],
+			box.width - 2 * padding, &rc.font_osd,
+			theme->osd_label_text_color, NULL);
+		wlr_scene_node_set_position(&line->scene_buffer->node,
+			padding, y);
+		y += line->height;
+		width = MAX(width, line->width);
+	}
+	wlr_scene_rect_set_size(stats->overlay.background,
+		width + 2 * padding, y + padding);
+}
+
+void
+frame_stats_overlay_destroy(struct output *output)
+{
+	struct frame_stats *stats = &output->frame_stats;
+	if (stats->overlay.tree) {
+		/* Takes the scaled_font_buffers along */
+		wlr_scene_node_destroy(&stats->overlay.tree->node);
+	}
+	memset(&stats->overlay, 0, sizeof(stats->overlay));
+}
+
+void
+frame_stats_overlay_toggle(struct server *server)
+{
+	overlay_enabled = !overlay_enabled;
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		if (overlay_enabled) {
+			frame_stats_overlay_update(output);
+		} else {
+			frame_stats_overlay_destroy(output);
+		}
+	}
+}
@@ -21,6 +21,7 @@
 #include "regions.h"
 #include "resistance.h"
 #include "ssd.h"
+#include "trace.h"
 #include "view.h"
 
 #define LAB_CURSOR_SHAPE_V1_VERSION 1
@@ -271,7 +272,7 @@ process_cursor_resize(struct server *server, uint32_t time)
 			server->grab_box.width - new_view_geo.width;
 	}
 
-	view_move_resize(view, new_view_geo);
+	interactive_resize_queue(view, new_view_geo);
 }
 
 void
@@ -356,6 +357,38 @@ update_pressed_surface(struct seat *seat, struct cursor_context *ctx)
 	return false;
 }
 
+static void
+handle_motion_surface_destroy(struct wl_listener *listener, void *data)
+{
+	struct seat *seat =
+		wl_container_of(listener, seat, motion.surface_destroy);
+	wl_list_remove(&seat->motion.surface_destroy.link);
+	wl_list_init(&seat->motion.surface_destroy.link);
+	seat->motion.surface = NULL;
+}
+
+/*
+ * Remember where the surface receiving motion events is located. The
+ * surface is forgotten once destroyed, so that a new surface allocated
+ * at the same address is not mistaken for it.
+ */
+static void
+set_motion_surface(struct seat *seat, struct wlr_surface *surface,
+		double sx, double sy)
+{
+	if (surface != seat->motion.surface) {
+		wl_list_remove(&seat->motion.surface_destroy.link);
+		wl_list_init(&seat->motion.surface_destroy.link);
+		if (surface) {
+			wl_signal_add(&surface->events.destroy,
+				&seat->motion.surface_destroy);
+		}
+		seat->motion.surface = surface;
+	}
+	seat->motion.surface_lx = seat->cursor->x - sx;
+	seat->motion.surface_ly = seat->cursor->y - sy;
+}
+
 static void
 process_cursor_motion_out_of_surface(struct server *server, uint32_t time)
 {
@@ -390,6 +423,7 @@ process_cursor_motion_out_of_surface(struct server *server, uint32_t time)
 	}
 
 	wlr_seat_pointer_notify_motion(server->seat.seat, time, sx, sy);
+	set_motion_surface(&server->seat, surface, sx, sy);
 }
 
 /*
@@ -462,6 +496,7 @@ cursor_update_common(struct server *server, struct cursor_context *ctx,
 			wlr_seat_pointer_notify_motion(wlr_seat, time_msec,
 				ctx->sx, ctx->sy);
 		}
+		set_motion_surface(seat, ctx->surface, ctx->sx, ctx->sy);
 	} else {
 		/*
 		 * Cursor is over a server (labwc) surface.  Clear focus
@@ -495,6 +530,7 @@ cursor_get_resize_edges(struct wlr_cursor *cursor, struct cursor_context *ctx)
 static void
 process_cursor_motion(struct server *server, uint32_t time)
 {
+	TRACE_SCOPE("process_cursor_motion");
 	/* If the mode is non-passthrough, delegate to those functions. */
 	if (server->input_mode == LAB_INPUT_STATE_MOVE) {
 		process_cursor_move(server, time);
@@ -524,19 +560,14 @@ process_cursor_motion(struct server *server, uint32_t time)
 	}
 
 	struct mousebind *mousebind;
-	wl_list_for_each(mousebind, &rc.mousebinds, link) {
-		if (mousebind->mouse_event == MOUSE_ACTION_DRAG
-				&& mousebind->pressed_in_context) {
-			/*
-			 * Use view and resize edges from the press
-			 * event (not the motion event) to prevent
-			 * moving/resizing the wrong view
-			 */
-			mousebind->pressed_in_context = false;
-			actions_run(seat->pressed.view,
-				server, &mousebind->actions,
-				seat->pressed.resize_edges);
-		}
+	while ((mousebind = mousebind_take_pressed_drag())) {
+		/*
+		 * Use view and resize edges from the press
+		 * event (not the motion event) to prevent
+		 * moving/resizing the wrong view
+		 */
+		actions_run(seat->pressed.view, server, &mousebind->actions,
+			seat->pressed.resize_edges);
 	}
 
 	cursor_update_common(server, &ctx, time, /*cursor_has_moved*/ true);
@@ -714,6 +745,44 @@ cursor_locked(struct seat *seat, struct wlr_pointer *pointer)
 		&& seat->current_constraint->type == WLR_POINTER_CONSTRAINT_V1_LOCKED;
 }
 
+static void
+cursor_flush_motion(struct seat *seat)
+{
+	if (!seat->motion.pending) {
+		return;
+	}
+	if (seat->motion.idle) {
+		wl_event_source_remove(seat->motion.idle);
+		seat->motion.idle = NULL;
+	}
+	seat->motion.pending = false;
+	seat->motion.processed++;
+	process_cursor_motion(seat->server, seat->motion.time_msec);
+}
+
+static void
+handle_motion_idle(void *data)
+{
+	struct seat *seat = data;
+	/* Idle sources are removed automatically once dispatched */
+	seat->motion.idle = NULL;
+	cursor_flush_motion(seat);
+}
+
+static void
+forward_coalesced_motion(struct seat *seat, uint32_t time_msec)
+{
+	struct wlr_surface *focused = seat->seat->pointer_state.focused_surface;
+	if (!focused || focused != seat->motion.surface
+			|| seat->server->input_mode != LAB_INPUT_STATE_PASSTHROUGH
+			|| seat->drag.active) {
+		return;
+	}
+	wlr_seat_pointer_notify_motion(seat->seat, time_msec,
+		seat->cursor->x - seat->motion.surface_lx,
+		seat->cursor->y - seat->motion.surface_ly);
+}
+
 static void
 preprocess_cursor_motion(struct seat *seat, struct wlr_pointer *pointer,
 		uint32_t time_msec, double dx, double dy)
@@ -732,7 +801,32 @@ preprocess_cursor_motion(struct seat *seat, struct wlr_pointer *pointer,
 	 * without any input.
 	 */
 	wlr_cursor_move(seat->cursor, &pointer->base, dx, dy);
-	process_cursor_motion(seat->server, time_msec);
+
+	seat->motion.received++;
+	if (!rc.coalesce_motion) {
+		seat->motion.processed++;
+		process_cursor_motion(seat->server, time_msec);
+		return;
+	}
+
+	/*
+	 * Defer hit-testing, focus changes and interactive move/resize
+	 * until all queued input events have been handled, but keep
+	 * sending motion events to the surface with pointer focus.
+	 */
+	forward_coalesced_motion(seat, time_msec);
+	seat->motion.time_msec = time_msec;
+	if (seat->motion.pending) {
+		return;
+	}
+	seat->motion.idle = wl_event_loop_add_idle(seat->server->wl_event_loop,
+		handle_motion_idle, seat);
+	if (!seat->motion.idle) {
+		seat->motion.processed++;
+		process_cursor_motion(seat->server, time_msec);
+		return;
+	}
+	seat->motion.pending = true;
 }
 
 static void
@@ -742,6 +836,7 @@ cursor_motion(struct wl_listener *listener, void *data)
 	 * This event is forwarded by the cursor when a pointer emits a
 	 * _relative_ pointer motion event (i.e. a delta)
 	 */
+	TRACE_SCOPE("cursor_motion");
 	struct seat *seat = wl_container_of(listener, seat, cursor_motion);
 	struct server *server = seat->server;
 	struct wlr_pointer_motion_event *event = data;
@@ -768,6 +863,7 @@ cursor_motion_absolute(struct wl_listener *listener, void *data)
 	 * window from any edge, so we have to warp the mouse there. There is
 	 * also some hardware which emits these events.
 	 */
+	TRACE_SCOPE("cursor_motion_absolute");
 	struct seat *seat = wl_container_of(
 		listener, seat, cursor_motion_absolute);
 	struct wlr_pointer_motion_absolute_event *event = data;
@@ -793,16 +889,16 @@ static bool
 handle_release_mousebinding(struct server *server,
 		struct cursor_context *ctx, uint32_t button)
 {
-	struct mousebind *mousebind;
 	bool consumed_by_frame_context = false;
 
 	uint32_t modifiers = wlr_keyboard_get_modifiers(
 			&server->seat.keyboard_group->keyboard);
 
-	wl_list_for_each(mousebind, &rc.mousebinds, link) {
-		if (ssd_part_contains(mousebind->context, ctx->type)
-				&& mousebind->button == button
-				&& modifiers == mousebind->modifiers) {
+	struct mousebind_match match =
+		mousebind_find_by_button(modifiers, button);
+	for (size_t i = 0; i < match.count; i++) {
+		struct mousebind *mousebind = match.mousebinds[i];
+		if (ssd_part_contains(mousebind->context, ctx->type)) {
 			switch (mousebind->mouse_event) {
 			case MOUSE_ACTION_RELEASE:
 				break;
@@ -833,11 +929,7 @@ handle_release_mousebinding(struct server *server,
 	 * Clear "pressed" status for all bindings of this mouse button,
 	 * regardless of whether handled or not
 	 */
-	wl_list_for_each(mousebind, &rc.mousebinds, link) {
-		if (mousebind->button == button) {
-			mousebind->pressed_in_context = false;
-		}
-	}
+	mousebind_clear_pressed(button);
 	return consumed_by_frame_context;
 }
 
@@ -874,17 +966,17 @@ static bool
 handle_press_mousebinding(struct server *server, struct cursor_context *ctx,
 		uint32_t button, uint32_t resize_edges)
 {
-	struct mousebind *mousebind;
 	bool double_click = is_double_click(rc.doubleclick_time, button, ctx->view);
 	bool consumed_by_frame_context = false;
 
 	uint32_t modifiers = wlr_keyboard_get_modifiers(
 			&server->seat.keyboard_group->keyboard);
 
-	wl_list_for_each(mousebind, &rc.mousebinds, link) {
-		if (ssd_part_contains(mousebind->context, ctx->type)
-				&& mousebind->button == button
-				&& modifiers == mousebind->modifiers) {
+	struct mousebind_match match =
+		mousebind_find_by_button(modifiers, button);
+	for (size_t i = 0; i < match.count; i++) {
+		struct mousebind *mousebind = match.mousebinds[i];
+		if (ssd_part_contains(mousebind->context, ctx->type)) {
 			switch (mousebind->mouse_event) {
 			case MOUSE_ACTION_DRAG: /* fallthrough */
 			case MOUSE_ACTION_CLICK:
@@ -900,7 +992,7 @@ handle_press_mousebinding(struct server *server, struct cursor_context *ctx,
 					 */
 					consumed_by_frame_context |=
 						mousebind->context == LAB_SSD_FRAME;
-					mousebind->pressed_in_context = true;
+					mousebind_set_pressed(mousebind);
 				}
 				continue;
 			case MOUSE_ACTION_DOUBLECLICK:
@@ -1057,9 +1149,11 @@ cursor_button(struct wl_listener *listener, void *data)
 	 * This event is forwarded by the cursor when a pointer emits a button
 	 * event.
 	 */
+	TRACE_SCOPE("cursor_button");
 	struct seat *seat = wl_container_of(listener, seat, cursor_button);
 	struct wlr_pointer_button_event *event = data;
 	idle_manager_notify_activity(seat->seat);
+	cursor_flush_motion(seat);
 
 	switch (event->state) {
 	case WLR_BUTTON_PRESSED:
@@ -1107,7 +1201,6 @@ static bool
 handle_cursor_axis(struct server *server, struct cursor_context *ctx,
 		struct wlr_pointer_axis_event *event)
 {
-	struct mousebind *mousebind;
 	bool handled = false;
 
 	uint32_t modifiers = wlr_keyboard_get_modifiers(
@@ -1136,11 +1229,11 @@ handle_cursor_axis(struct server *server, struct cursor_context *ctx,
 		return false;
 	}
 
-	wl_list_for_each(mousebind, &rc.mousebinds, link) {
-		if (ssd_part_contains(mousebind->context, ctx->type)
-				&& mousebind->direction == direction
-				&& modifiers == mousebind->modifiers
-				&& mousebind->mouse_event == MOUSE_ACTION_SCROLL) {
+	struct mousebind_match match =
+		mousebind_find_by_direction(modifiers, direction);
+	for (size_t i = 0; i < match.count; i++) {
+		struct mousebind *mousebind = match.mousebinds[i];
+		if (ssd_part_contains(mousebind->context, ctx->type)) {
 			handled = true;
 			actions_run(ctx->view, server, &mousebind->actions, /*resize_edges*/ 0);
 		}
@@ -1159,6 +1252,7 @@ cursor_axis(struct wl_listener *listener, void *data)
 	struct seat *seat = wl_container_of(listener, seat, cursor_axis);
 	struct wlr_pointer_axis_event *event = data;
 	struct server *server = seat->server;
+	cursor_flush_motion(seat);
 	struct cursor_context ctx = get_cursor_context(server);
 	idle_manager_notify_activity(seat->seat);
 
@@ -1239,6 +1333,9 @@ cursor_init(struct seat *seat)
 
 	dnd_init(seat);
 
+	seat->motion.surface_destroy.notify = handle_motion_surface_destroy;
+	wl_list_init(&seat->motion.surface_destroy.link);
+
 	seat->cursor_motion.notify = cursor_motion;
 	wl_signal_add(&seat->cursor->events.motion, &seat->cursor_motion);
 	seat->cursor_motion_absolute.notify = cursor_motion_absolute;
@@ -1281,6 +1378,12 @@ cursor_init(struct seat *seat)
 
 void cursor_finish(struct seat *seat)
 {
+	if (seat->motion.idle) {
+		wl_event_source_remove(seat->motion.idle);
+		seat->motion.idle = NULL;
+	}
+	wl_list_remove(&seat->motion.surface_destroy.link);
+
 	/* TODO: either clean up all the listeners or none of them */
 
 	wl_list_remove(&seat->cursor_motion.link);
@@ -10,6 +10,7 @@
 #include "labwc.h"
 #include "menu/menu.h"
 #include "regions.h"
+#include "trace.h"
 #include "view.h"
 #include "workspaces.h"
 
@@ -98,34 +99,16 @@ static struct keybind *
 match_keybinding_for_sym(struct server *server, uint32_t modifiers,
 		xkb_keysym_t sym, xkb_keycode_t xkb_keycode)
 {
-	struct keybind *keybind;
-	wl_list_for_each(keybind, &rc.keybinds, link) {
-		if (modifiers ^ keybind->modifiers) {
-			continue;
-		}
-		if (server->seat.nr_inhibited_keybind_views
-				&& server->active_view
-				&& server->active_view->inhibits_keybinds
-				&& !actions_contain_toggle_keybinds(&keybind->actions)) {
-			continue;
-		}
-		if (sym == XKB_KEY_NoSymbol) {
-			/* Use keycodes */
-			for (size_t i = 0; i < keybind->keycodes_len; i++) {
-				if (keybind->keycodes[i] == xkb_keycode) {
-					return keybind;
-				}
-			}
-		} else {
-			/* Use syms */
-			for (size_t i = 0; i < keybind->keysyms_len; i++) {
-				if (xkb_keysym_to_lower(sym) == keybind->keysyms[i]) {
-					return keybind;
-				}
-			}
-		}
-	}
-	return NULL;
+	bool toggle_only = server->seat.nr_inhibited_keybind_views
+		&& server->active_view
+		&& server->active_view->inhibits_keybinds;
+	if (sym == XKB_KEY_NoSymbol) {
+		/* Use keycodes */
+		return keybind_find_by_keycode(modifiers, xkb_keycode,
+			toggle_only);
+	}
+	/* Use syms */
+	return keybind_find_by_sym(modifiers, sym, toggle_only);
 }
 
 /*
@@ -491,6 +474,7 @@ static void
 keyboard_key_notify(struct wl_listener *listener, void *data)
 {
 	/* This event is raised when a key is pressed or released. */
+	TRACE_SCOPE("keyboard_key_notify");
 	struct keyboard *keyboard = wl_container_of(listener, keyboard, key);
 	struct seat *seat = keyboard->base.seat;
 	struct wlr_keyboard_key_event *event = data;
@@ -26,7 +26,7 @@ touch_get_coords(struct seat *seat, struct wlr_touch *touch, double x, double y,
 
 	double sx, sy;
 	struct wlr_scene_node *node =
-		wlr_scene_node_at(&seat->server->scene->tree.node, lx, ly, &sx, &sy);
+		desktop_node_at(seat->server, lx, ly, &sx, &sy);
 
 	*x_offset = lx - sx;
 	*y_offset = ly - sy;
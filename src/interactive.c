@@ -1,7 +1,9 @@
 // SPDX-License-Identifier: GPL-2.0-only
+#include <inttypes.h>
 #include "input/keyboard.h"
 #include "labwc.h"
 #include "regions.h"
+#include "resistance.h"
 #include "resize_indicator.h"
 #include "view.h"
 #include "window-rules.h"
@@ -36,7 +38,7 @@ interactive_begin(struct view *view, enum input_mode mode, uint32_t edges)
 	}
 
 	/* Prevent moving/resizing fixed-position and panel-like views */
-	if (window_rules_get_property(view, "fixedPosition") == LAB_PROP_TRUE
+	if (window_rules_get_property(view, LAB_RULE_PROP_FIXED_POSITION) == LAB_PROP_TRUE
 			|| view_has_strut_partial(view)) {
 		return;
 	}
@@ -107,6 +109,7 @@ interactive_begin(struct view *view, enum input_mode mode, uint32_t edges)
 	server->grab_y = seat->cursor->y;
 	server->grab_box = geometry;
 	server->resize_edges = edges;
+	resistance_begin(view);
 	if (rc.resize_indicator) {
 		resize_indicator_show(view);
 	}
@@ -181,10 +184,62 @@ snap_to_region(struct view *view)
 	return false;
 }
 
+/*
+ * Interactive resize sends at most one size changing configure request per
+ * output frame and only once the client has acked the previous one. Slow
+ * clients are thus not flooded with requests they can not keep up with.
+ * Geometry requested in the meantime replaces the queued one, so the
+ * client always receives the newest size next.
+ */
+void
+interactive_resize_queue(struct view *view, struct wlr_box geo)
+{
+	view->resize_queue.geometry = geo;
+	view->resize_queue.queued = true;
+	if (output_is_usable(view->output)) {
+		/* Applied from output_frame_notify() */
+		wlr_output_schedule_frame(view->output->wlr_output);
+	} else {
+		interactive_resize_flush(view);
+	}
+}
+
+void
+interactive_resize_flush(struct view *view)
+{
+	if (!view->resize_queue.queued || view->pending_configure_serial) {
+		return;
+	}
+	view->resize_queue.queued = false;
+	view_move_resize(view, view->resize_queue.geometry);
+}
+
+static void
+log_configure_stats(struct view *view)
+{
+	struct configure_stats *stats = &view->configure_stats;
+	if (!stats->count) {
+		return;
+	}
+	wlr_log(WLR_DEBUG, "configure round-trip of (%s): %" PRIu64
+		" acked, %" PRIu64 " timed out, avg %" PRIu64 " us, max %"
+		PRIu64 " us", view_get_string_prop(view, "app_id"),
+		stats->count, stats->timeouts, stats->total_usec / stats->count,
+		stats->max_usec);
+}
+
 void
 interactive_finish(struct view *view)
 {
 	if (view->server->grabbed_view == view) {
+		if (view->resize_queue.queued) {
+			/* Always apply the final geometry */
+			view->resize_queue.queued = false;
+			view_move_resize(view, view->resize_queue.geometry);
+		}
+		if (view->server->input_mode == LAB_INPUT_STATE_RESIZE) {
+			log_configure_stats(view);
+		}
 		regions_hide_overlay(&view->server->seat);
 		if (view->server->input_mode == LAB_INPUT_STATE_MOVE) {
 			if (!snap_to_region(view)) {
@@ -195,6 +250,7 @@ interactive_finish(struct view *view)
 			}
 		}
 		resize_indicator_hide(view);
+		resistance_finish();
 
 		view->server->input_mode = LAB_INPUT_STATE_PASSTHROUGH;
 		view->server->grabbed_view = NULL;
@@ -213,7 +269,9 @@ void
 interactive_cancel(struct view *view)
 {
 	if (view->server->grabbed_view == view) {
+		view->resize_queue.queued = false;
 		resize_indicator_hide(view);
+		resistance_finish();
 		view->server->input_mode = LAB_INPUT_STATE_PASSTHROUGH;
 		view->server->grabbed_view = NULL;
 		/* Update focus/cursor image */
@@ -160,6 +160,44 @@ process_keyboard_interactivity(struct lab_layer_surface *layer)
 	}
 }
 
+/*
+ * Returns the WLR_LAYER_SURFACE_V1_STATE_* bits of the state that
+ * differs from the last arrangement, and remembers the current state.
+ */
+static uint32_t
+layer_state_changes(struct lab_layer_surface *layer)
+{
+	struct wlr_layer_surface_v1_state *old = &layer->arranged_state;
+	struct wlr_layer_surface_v1_state *new =
+		&layer->scene_layer_surface->layer_surface->current;
+	uint32_t changed = 0;
+
+	if (old->desired_width != new->desired_width
+			|| old->desired_height != new->desired_height) {
+		changed |= WLR_LAYER_SURFACE_V1_STATE_DESIRED_SIZE;
+	}
+	if (old->anchor != new->anchor) {
+		changed |= WLR_LAYER_SURFACE_V1_STATE_ANCHOR;
+	}
+	if (old->exclusive_zone != new->exclusive_zone) {
+		changed |= WLR_LAYER_SURFACE_V1_STATE_EXCLUSIVE_ZONE;
+	}
+	if (old->margin.top != new->margin.top
+			|| old->margin.right != new->margin.right
+			|| old->margin.bottom != new->margin.bottom
+			|| old->margin.left != new->margin.left) {
+		changed |= WLR_LAYER_SURFACE_V1_STATE_MARGIN;
+	}
+	if (old->keyboard_interactive != new->keyboard_interactive) {
+		changed |= WLR_LAYER_SURFACE_V1_STATE_KEYBOARD_INTERACTIVITY;
+	}
+	if (old->layer != new->layer) {
+		changed |= WLR_LAYER_SURFACE_V1_STATE_LAYER;
+	}
+	*old = *new;
+	return changed;
+}
+
 static void
 handle_surface_commit(struct wl_listener *listener, void *data)
 {
@@ -174,21 +212,31 @@ handle_surface_commit(struct wl_listener *listener, void *data)
 		return;
 	}
 
-	uint32_t committed = layer_surface->current.committed;
 	struct output *output = (struct output *)wlr_output->data;
+	output->layer_stats.commits++;
+
+	/*
+	 * Clients re-send unchanged state with every frame, so compare
+	 * against what was last arranged rather than trusting the
+	 * committed bits. Buffer-only commits end up with no changes.
+	 */
+	uint32_t changed = layer_state_changes(layer);
 
 	/* Process layer change */
-	if (committed & WLR_LAYER_SURFACE_V1_STATE_LAYER) {
+	if (changed & WLR_LAYER_SURFACE_V1_STATE_LAYER) {
 		wlr_scene_node_reparent(&layer->scene_layer_surface->tree->node,
 			output->layer_tree[layer_surface->current.layer]);
 	}
 	/* Process keyboard-interactivity change */
-	if (committed & WLR_LAYER_SURFACE_V1_STATE_KEYBOARD_INTERACTIVITY) {
+	if (changed & WLR_LAYER_SURFACE_V1_STATE_KEYBOARD_INTERACTIVITY) {
 		process_keyboard_interactivity(layer);
 	}
 
-	if (committed || layer->mapped != layer_surface->surface->mapped) {
+	if (changed || !layer->arranged
+			|| layer->mapped != layer_surface->surface->mapped) {
+		layer->arranged = true;
 		layer->mapped = layer_surface->surface->mapped;
+		output->layer_stats.layer_arranges++;
 		output_update_usable_area(output);
 		/*
 		 * Update cursor focus here to ensure we
@@ -228,6 +276,15 @@ handle_unmap(struct wl_listener *listener, void *data)
 	if (layer_surface->output) {
 		output_update_usable_area(layer_surface->output->data);
 	}
+
+	/*
+	 * The client has to send its initial commit again and wait for a
+	 * configure before it can map, even if its state is the same as
+	 * before the unmap.
+	 */
+	layer->arranged = false;
+	layer->mapped = false;
+
 	struct seat *seat = &layer->server->seat;
 	if (seat->focused_layer == layer_surface) {
 		seat_set_focus_layer(seat, NULL);
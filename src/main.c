@@ -182,6 +182,8 @@ main(int argc, char *argv[])
 
 	menu_finish(&server);
 	theme_finish(&theme);
+	theme_cache_finish();
+	menu_pipe_cache_finish();
 	rcxml_finish();
 	font_finish();
 	return 0;
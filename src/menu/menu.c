@@ -1,12 +1,17 @@
 // SPDX-License-Identifier: GPL-2.0-only
 #define _POSIX_C_SOURCE 200809L
 #include <assert.h>
+#include <errno.h>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 #include <wayland-server-core.h>
 #include <wlr/util/log.h>
 #include "action.h"
@@ -18,6 +23,7 @@
 #include "common/nodename.h"
 #include "common/scaled_font_buffer.h"
 #include "common/scene-helpers.h"
+#include "common/spawn.h"
 #include "common/string-helpers.h"
 #include "labwc.h"
 #include "menu/menu.h"
@@ -31,6 +37,35 @@ static struct action *current_item_action;
 
 static int menu_level;
 static struct menu *current_menu;
+/* Pipemenu whose output is being parsed, owns all menus created meanwhile */
+static struct menu *current_pipemenu;
+
+/* Hung pipemenu generators are killed after this time */
+#define PIPEMENU_TIMEOUT_MS 10000
+/* Upper bound for the output of a pipemenu generator */
+#define PIPEMENU_MAX_SIZE (1024 * 1024)
+
+/* Output of pipemenu generators by command, kept across reconfigure */
+struct pipe_cache_entry {
+	char *command;
+	char *output;
+	uint64_t time; /* msec */
+	uint64_t serial;
+	struct wl_list link; /* pipe_cache.entries */
+};
+
+/* Initialised statically as menu_init() runs again on every reconfigure */
+static struct {
+	struct wl_list entries;
+	uint64_t serial;
+} pipe_cache = {
+	.entries = { &pipe_cache.entries, &pipe_cache.entries },
+};
+
+/* Releases the scene nodes of closed menus, see rc.menu_release_timeout */
+static struct wl_event_source *release_timer;
+
+static const char arrow_symbol[] = "›";
 
 /* TODO: split this whole file into parser.c and actions.c*/
 
@@ -44,11 +79,11 @@ menu_create(struct server *server, const char *id, const char *label)
 	menu->id = xstrdup(id);
 	menu->label = xstrdup(label ? label : id);
 	menu->parent = current_menu;
+	menu->pipe_owner = current_pipemenu;
 	menu->server = server;
 	menu->size.width = server->theme->menu_min_width;
 	/* menu->size.height will be kept up to date by adding items */
-	menu->scene_tree = wlr_scene_tree_create(server->menu_tree);
-	wlr_scene_node_set_enabled(&menu->scene_tree->node, false);
+	/* menu->scene_tree is only created once the menu gets opened */
 	return menu;
 }
 
@@ -67,56 +102,35 @@ menu_get_by_id(struct server *server, const char *id)
 	return NULL;
 }
 
+/* Measure the item labels and derive the menu width from the widest one */
 static void
 menu_update_width(struct menu *menu)
 {
+	if (menu->measured) {
+		return;
+	}
+
 	struct menuitem *item;
 	struct theme *theme = menu->server->theme;
 	int max_width = theme->menu_min_width;
 
 	/* Get widest menu item, clamped by menu_max_width */
 	wl_list_for_each(item, &menu->menuitems, link) {
+		if (!item->text) {
+			continue;
+		}
+		item->native_width = font_width(&rc.font_menuitem, item->text);
+		if (item->arrow) {
+			item->native_width += font_width(&rc.font_menuitem,
+				arrow_symbol);
+		}
 		if (item->native_width > max_width) {
 			max_width = item->native_width < theme->menu_max_width
 				? item->native_width : theme->menu_max_width;
 		}
 	}
 	menu->size.width = max_width + 2 * theme->menu_item_padding_x;
-
-	/* Update all items for the new size */
-	wl_list_for_each(item, &menu->menuitems, link) {
-		wlr_scene_rect_set_size(
-			wlr_scene_rect_from_node(item->normal.background),
-			menu->size.width, item->height);
-
-		if (!item->selected.background) {
-			/* This is a separator. They don't have a selected background. */
-			wlr_scene_rect_set_size(
-				wlr_scene_rect_from_node(item->normal.text),
-				menu->size.width - 2 * theme->menu_separator_padding_width,
-				theme->menu_separator_line_thickness);
-		} else {
-			/* Usual menu item */
-			wlr_scene_rect_set_size(
-				wlr_scene_rect_from_node(item->selected.background),
-				menu->size.width, item->height);
-			if (item->native_width > max_width || item->submenu) {
-				scaled_font_buffer_set_max_width(item->normal.buffer,
-					max_width);
-				scaled_font_buffer_set_max_width(item->selected.buffer,
-					max_width);
-			}
-		}
-	}
-}
-
-static void
-post_processing(struct server *server)
-{
-	struct menu *menu;
-	wl_list_for_each(menu, &server->menus, link) {
-		menu_update_width(menu);
-	}
+	menu->measured = true;
 }
 
 static void
@@ -144,16 +158,19 @@ validate(struct server *server)
 	}
 }
 
+/*
+ * Items only describe the menu while parsing. Their scene nodes are created
+ * by item_scene_create() once the parent menu is opened for the first time.
+ */
 static struct menuitem *
 item_create(struct menu *menu, const char *text, bool show_arrow)
 {
 	struct menuitem *menuitem = znew(*menuitem);
 	menuitem->parent = menu;
 	menuitem->selectable = true;
-	struct server *server = menu->server;
-	struct theme *theme = server->theme;
-
-	const char *arrow = show_arrow ? "›" : NULL;
+	menuitem->text = xstrdup(text);
+	menuitem->arrow = show_arrow;
+	struct theme *theme = menu->server->theme;
 
 	if (!menu->item_height) {
 		menu->item_height = font_height(&rc.font_menuitem)
@@ -161,10 +178,45 @@ item_create(struct menu *menu, const char *text, bool show_arrow)
 	}
 	menuitem->height = menu->item_height;
 
-	int x, y;
-	menuitem->native_width = font_width(&rc.font_menuitem, text);
-	if (arrow) {
-		menuitem->native_width += font_width(&rc.font_menuitem, arrow);
+	/* Position the item in relation to its menu */
+	menuitem->y = menu->size.height;
+
+	/* Update menu extents */
+	menu->size.height += menuitem->height;
+
+	wl_list_append(&menu->menuitems, &menuitem->link);
+	wl_list_init(&menuitem->actions);
+	return menuitem;
+}
+
+static struct menuitem *
+separator_create(struct menu *menu, const char *label)
+{
+	struct menuitem *menuitem = znew(*menuitem);
+	menuitem->parent = menu;
+	menuitem->selectable = false;
+	struct theme *theme = menu->server->theme;
+	menuitem->height = theme->menu_separator_line_thickness +
+			2 * theme->menu_separator_padding_height;
+
+	menuitem->y = menu->size.height;
+	menu->size.height += menuitem->height;
+	wl_list_append(&menu->menuitems, &menuitem->link);
+	wl_list_init(&menuitem->actions);
+	return menuitem;
+}
+
+static void
+item_scene_create(struct menuitem *menuitem)
+{
+	struct menu *menu = menuitem->parent;
+	struct theme *theme = menu->server->theme;
+	const char *arrow = menuitem->arrow ? arrow_symbol : NULL;
+
+	/* Truncate long labels and right-align the arrow of submenu items */
+	int max_width = menu->size.width - 2 * theme->menu_item_padding_x;
+	if (menuitem->native_width < max_width && !menuitem->submenu) {
+		max_width = menuitem->native_width;
 	}
 
 	/* Menu item root node */
@@ -179,66 +231,59 @@ item_create(struct menu *menu, const char *text, bool show_arrow)
 	/* Item background nodes */
 	menuitem->normal.background = &wlr_scene_rect_create(
 		menuitem->normal.tree,
-		menu->size.width, menu->item_height,
+		menu->size.width, menuitem->height,
 		theme->menu_items_bg_color)->node;
 	menuitem->selected.background = &wlr_scene_rect_create(
 		menuitem->selected.tree,
-		menu->size.width, menu->item_height,
+		menu->size.width, menuitem->height,
 		theme->menu_items_active_bg_color)->node;
 
 	/* Font nodes */
 	menuitem->normal.buffer = scaled_font_buffer_create(menuitem->normal.tree);
 	menuitem->selected.buffer = scaled_font_buffer_create(menuitem->selected.tree);
 	if (!menuitem->normal.buffer || !menuitem->selected.buffer) {
-		wlr_log(WLR_ERROR, "Failed to create menu item '%s'", text);
+		wlr_log(WLR_ERROR, "Failed to create menu item '%s'",
+			menuitem->text);
 		/*
 		 * Destroying the root node will destroy everything,
 		 * including the node descriptor and scaled_font_buffers.
+		 * The item stays in the menu model without a visual.
 		 */
 		wlr_scene_node_destroy(&menuitem->tree->node);
-		free(menuitem);
-		return NULL;
+		menuitem->tree = NULL;
+		menuitem->normal = (struct menu_scene){ 0 };
+		menuitem->selected = (struct menu_scene){ 0 };
+		return;
 	}
 	menuitem->normal.text = &menuitem->normal.buffer->scene_buffer->node;
 	menuitem->selected.text = &menuitem->selected.buffer->scene_buffer->node;
 
 	/* Font buffers */
-	scaled_font_buffer_update(menuitem->normal.buffer, text, menuitem->native_width,
-		&rc.font_menuitem, theme->menu_items_text_color, arrow);
-	scaled_font_buffer_update(menuitem->selected.buffer, text, menuitem->native_width,
-		&rc.font_menuitem, theme->menu_items_active_text_color, arrow);
+	scaled_font_buffer_update(menuitem->normal.buffer, menuitem->text,
+		max_width, &rc.font_menuitem, theme->menu_items_text_color,
+		arrow);
+	scaled_font_buffer_update(menuitem->selected.buffer, menuitem->text,
+		max_width, &rc.font_menuitem,
+		theme->menu_items_active_text_color, arrow);
 
 	/* Center font nodes */
-	x = theme->menu_item_padding_x;
-	y = (menu->item_height - menuitem->normal.buffer->height) / 2;
+	int x = theme->menu_item_padding_x;
+	int y = (menuitem->height - menuitem->normal.buffer->height) / 2;
 	wlr_scene_node_set_position(menuitem->normal.text, x, y);
-	y = (menu->item_height - menuitem->selected.buffer->height) / 2;
+	y = (menuitem->height - menuitem->selected.buffer->height) / 2;
 	wlr_scene_node_set_position(menuitem->selected.text, x, y);
 
-	/* Position the item in relation to its menu */
-	wlr_scene_node_set_position(&menuitem->tree->node, 0, menu->size.height);
+	wlr_scene_node_set_position(&menuitem->tree->node, 0, menuitem->y);
 
 	/* Hide selected state */
 	wlr_scene_node_set_enabled(&menuitem->selected.tree->node, false);
-
-	/* Update menu extents */
-	menu->size.height += menuitem->height;
-
-	wl_list_append(&menu->menuitems, &menuitem->link);
-	wl_list_init(&menuitem->actions);
-	return menuitem;
 }
 
-static struct menuitem *
-separator_create(struct menu *menu, const char *label)
+static void
+separator_scene_create(struct menuitem *menuitem)
 {
-	struct menuitem *menuitem = znew(*menuitem);
-	menuitem->parent = menu;
-	menuitem->selectable = false;
-	struct server *server = menu->server;
-	struct theme *theme = server->theme;
-	menuitem->height = theme->menu_separator_line_thickness +
-			2 * theme->menu_separator_padding_height;
+	struct menu *menu = menuitem->parent;
+	struct theme *theme = menu->server->theme;
 
 	menuitem->tree = wlr_scene_tree_create(menu->scene_tree);
 	node_descriptor_create(&menuitem->tree->node,
@@ -256,17 +301,82 @@ separator_create(struct menu *menu, const char *label)
 		theme->menu_separator_line_thickness,
 		theme->menu_separator_color)->node;
 
-	wlr_scene_node_set_position(&menuitem->tree->node, 0, menu->size.height);
+	wlr_scene_node_set_position(&menuitem->tree->node, 0, menuitem->y);
 
 	/* Vertically center-align separator line */
 	wlr_scene_node_set_position(menuitem->normal.text,
 		theme->menu_separator_padding_width,
 		theme->menu_separator_padding_height);
+}
 
-	menu->size.height += menuitem->height;
-	wl_list_append(&menu->menuitems, &menuitem->link);
-	wl_list_init(&menuitem->actions);
-	return menuitem;
+/* Create the scene nodes of a menu and its items unless they already exist */
+static void
+menu_scene_create(struct menu *menu)
+{
+	if (menu->scene_tree) {
+		return;
+	}
+	menu_update_width(menu);
+	menu->scene_tree = wlr_scene_tree_create(menu->server->menu_tree);
+	wlr_scene_node_set_enabled(&menu->scene_tree->node, false);
+	wlr_scene_node_set_position(&menu->scene_tree->node,
+		menu->position.x, menu->position.y);
+
+	struct menuitem *item;
+	wl_list_for_each(item, &menu->menuitems, link) {
+		if (item->text) {
+			item_scene_create(item);
+		} else {
+			separator_scene_create(item);
+		}
+	}
+}
+
+/* Release the scene nodes and rendered labels of a menu */
+static void
+menu_scene_destroy(struct menu *menu)
+{
+	if (!menu->scene_tree) {
+		return;
+	}
+	struct menuitem *item;
+	wl_list_for_each(item, &menu->menuitems, link) {
+		item->tree = NULL;
+		item->normal = (struct menu_scene){ 0 };
+		item->selected = (struct menu_scene){ 0 };
+	}
+	menu->selection.item = NULL;
+	menu->selection.menu = NULL;
+	/*
+	 * Destroying the root node will destroy everything,
+	 * including node descriptors and scaled_font_buffers.
+	 */
+	wlr_scene_node_destroy(&menu->scene_tree->node);
+	menu->scene_tree = NULL;
+}
+
+static int
+handle_release_timeout(void *data)
+{
+	struct server *server = data;
+	if (server->menu_current) {
+		/* Re-armed once the menu is closed again */
+		return 0;
+	}
+	struct menu *menu;
+	wl_list_for_each(menu, &server->menus, link) {
+		menu_scene_destroy(menu);
+	}
+	return 0;
+}
+
+static void
+schedule_release(void)
+{
+	if (release_timer && rc.menu_release_timeout > 0) {
+		wl_event_source_timer_update(release_timer,
+			rc.menu_release_timeout);
+	}
 }
 
 /*
@@ -313,7 +423,10 @@ item_destroy(struct menuitem *item)
 {
 	wl_list_remove(&item->link);
 	action_list_free(&item->actions);
-	wlr_scene_node_destroy(&item->tree->node);
+	if (item->tree) {
+		wlr_scene_node_destroy(&item->tree->node);
+	}
+	free(item->text);
 	free(item);
 }
 
@@ -417,8 +530,24 @@ handle_menu_element(xmlNode *n, struct server *server)
 	char *execute = (char *)xmlGetProp(n, (const xmlChar *)"execute");
 	char *id = (char *)xmlGetProp(n, (const xmlChar *)"id");
 
-	if (execute) {
-		wlr_log(WLR_ERROR, "we do not support pipemenus");
+	if (execute && label && id && menu_level > 0) {
+		/*
+		 * <menu id="" label="" execute=""> is a pipemenu, its content
+		 * is generated when it gets opened
+		 */
+		current_item = item_create(current_menu, label, true);
+		current_item->submenu = menu_create(server, id, label);
+		current_item->submenu->execute = xstrdup(execute);
+	} else if (execute && id && menu_level == 0) {
+		/*
+		 * A pipemenu at the highest level, which can be shown by
+		 * ShowMenu or linked into other menus by its id
+		 */
+		struct menu *pipemenu = menu_create(server, id, label);
+		pipemenu->execute = xstrdup(execute);
+	} else if (execute) {
+		wlr_log(WLR_ERROR, "pipemenu '%s' requires an id and, inside "
+			"another menu, a label", execute);
 	} else if ((label && id) || (id && nr_parents(n) == 2)) {
 		/*
 		 * (label && id) refers to <menu id="" label=""> which is an
@@ -512,11 +641,7 @@ xml_tree_walk(xmlNode *node, struct server *server)
 	}
 }
 
-/*
- * @stream can come from either of the following:
- *   - fopen() in the case of reading a file such as menu.xml
- *   - popen() when processing pipemenus
- */
+/* Read menu.xml, see parse_pipemenu() for pipemenu output */
 static void
 parse(struct server *server, FILE *stream)
 {
@@ -545,11 +670,33 @@ err:
 	free(b.buf);
 }
 
+/* Identity of the menu file last read, all zero if there was none */
+static struct {
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	struct timespec mtime;
+} menu_file;
+
+static void
+menu_file_stat(const char *path)
+{
+	struct stat st;
+	memset(&menu_file, 0, sizeof(menu_file));
+	if (path && !stat(path, &st)) {
+		menu_file.dev = st.st_dev;
+		menu_file.ino = st.st_ino;
+		menu_file.size = st.st_size;
+		menu_file.mtime = st.st_mtim;
+	}
+}
+
 static void
 parse_xml(const char *filename, struct server *server)
 {
 	static char buf[4096] = { 0 };
 
+	menu_file_stat(NULL);
 	if (!rc.config_dir) {
 		return;
 	}
@@ -561,13 +708,34 @@ parse_xml(const char *filename, struct server *server)
 		return;
 	}
 	wlr_log(WLR_INFO, "read menu file %s", buf);
+	menu_file_stat(buf);
 	parse(server, stream);
 	fclose(stream);
 }
 
+bool
+menu_file_changed(void)
+{
+	char path[4096];
+	if (!rc.config_dir) {
+		return menu_file.ino != 0;
+	}
+	snprintf(path, sizeof(path), "%s/menu.xml", rc.config_dir);
+
+	struct stat st;
+	if (stat(path, &st)) {
+		return menu_file.ino != 0;
+	}
+	return st.st_dev != menu_file.dev || st.st_ino != menu_file.ino
+		|| st.st_size != menu_file.size
+		|| st.st_mtim.tv_sec != menu_file.mtime.tv_sec
+		|| st.st_mtim.tv_nsec != menu_file.mtime.tv_nsec;
+}
+
 static int
 menu_get_full_width(struct menu *menu)
 {
+	menu_update_width(menu);
 	int width = menu->size.width - menu->server->theme->menu_overlap_x;
 	int child_width;
 	int max_child_width = 0;
@@ -589,6 +757,11 @@ menu_configure(struct menu *menu, int lx, int ly, enum menu_align align)
 {
 	struct theme *theme = menu->server->theme;
 
+	menu->anchor.x = lx;
+	menu->anchor.y = ly;
+	menu->anchor.align = align;
+	menu_update_width(menu);
+
 	/* Get output local coordinates + output usable area */
 	double ox = lx;
 	double oy = ly;
@@ -632,7 +805,11 @@ menu_configure(struct menu *menu, int lx, int ly, enum menu_align align)
 			ly += menu->item_height;
 		}
 	}
-	wlr_scene_node_set_position(&menu->scene_tree->node, lx, ly);
+	menu->position.x = lx;
+	menu->position.y = ly;
+	if (menu->scene_tree) {
+		wlr_scene_node_set_position(&menu->scene_tree->node, lx, ly);
+	}
 
 	int rel_y;
 	int new_lx, new_ly;
@@ -646,12 +823,333 @@ menu_configure(struct menu *menu, int lx, int ly, enum menu_align align)
 		} else {
 			new_lx = lx;
 		}
-		rel_y = item->tree->node.y;
+		rel_y = item->y;
 		new_ly = ly + rel_y - theme->menu_overlap_y;
 		menu_configure(item->submenu, new_lx, new_ly, align);
 	}
 }
 
+/*
+ * Pipemenu output looks like this:
+ *
+ * <openbox_pipe_menu>
+ *   <item label="">...</item>
+ *   <menu id="" label="">...</menu>
+ * </openbox_pipe_menu>
+ *
+ * The root element is renamed and wrapped so that the elements below it get
+ * the same nodenames as the content of a <menu> defined in menu.xml.
+ */
+static void
+parse_pipemenu(struct menu *pipemenu, const char *output)
+{
+	xmlDoc *d = xmlParseMemory(output, strlen(output));
+	if (!d) {
+		wlr_log(WLR_ERROR, "invalid output from pipemenu '%s'",
+			pipemenu->execute);
+		return;
+	}
+	xmlNode *root = xmlDocGetRootElement(d);
+	if (!root) {
+		xmlFreeDoc(d);
+		return;
+	}
+	xmlNode *wrapper = xmlNewNode(NULL, (const xmlChar *)"openbox_menu");
+	xmlDocSetRootElement(d, wrapper);
+	xmlAddChild(wrapper, root);
+	xmlNodeSetName(root, (const xmlChar *)"menu");
+
+	struct menu *saved_menu = current_menu;
+	int saved_level = menu_level;
+	current_menu = pipemenu;
+	current_pipemenu = pipemenu;
+	current_item = NULL;
+	menu_level = 1;
+
+	xml_tree_walk(root->children, pipemenu->server);
+
+	current_menu = saved_menu;
+	current_pipemenu = NULL;
+	current_item = NULL;
+	menu_level = saved_level;
+	xmlFreeDoc(d);
+}
+
+static uint64_t
+get_msec(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static bool
+pipe_cache_fresh(struct pipe_cache_entry *entry)
+{
+	return entry && get_msec() - entry->time
+		< (uint64_t)rc.menu_pipemenu_cache_time;
+}
+
+static void
+pipe_cache_entry_destroy(struct pipe_cache_entry *entry)
+{
+	wl_list_remove(&entry->link);
+	free(entry->command);
+	free(entry->output);
+	free(entry);
+}
+
+static struct pipe_cache_entry *
+pipe_cache_find(const char *command)
+{
+	struct pipe_cache_entry *entry;
+	wl_list_for_each(entry, &pipe_cache.entries, link) {
+		if (!strcmp(entry->command, command)) {
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+/* Takes ownership of @output */
+static struct pipe_cache_entry *
+pipe_cache_store(const char *command, char *output)
+{
+	struct pipe_cache_entry *entry = pipe_cache_find(command);
+	if (entry) {
+		pipe_cache_entry_destroy(entry);
+	}
+
+	/* Drop expired output of other commands while at it */
+	struct pipe_cache_entry *tmp;
+	wl_list_for_each_safe(entry, tmp, &pipe_cache.entries, link) {
+		if (!pipe_cache_fresh(entry)) {
+			pipe_cache_entry_destroy(entry);
+		}
+	}
+
+	entry = znew(*entry);
+	entry->command = xstrdup(command);
+	entry->output = output;
+	entry->time = get_msec();
+	entry->serial = ++pipe_cache.serial;
+	wl_list_insert(&pipe_cache.entries, &entry->link);
+	return entry;
+}
+
+void
+menu_pipe_cache_finish(void)
+{
+	struct pipe_cache_entry *entry, *tmp;
+	wl_list_for_each_safe(entry, tmp, &pipe_cache.entries, link) {
+		pipe_cache_entry_destroy(entry);
+	}
+}
+
+static void menu_destroy(struct menu *menu);
+
+static struct menu *
+pipemenu_owned_menu(struct menu *pipemenu)
+{
+	struct menu *menu;
+	wl_list_for_each(menu, &pipemenu->server->menus, link) {
+		if (menu->pipe_owner == pipemenu) {
+			return menu;
+		}
+	}
+	return NULL;
+}
+
+/* Remove all items as well as the menus defined by a pipemenu's output */
+static void
+menu_clear(struct menu *menu)
+{
+	struct menu *owned;
+	while ((owned = pipemenu_owned_menu(menu))) {
+		menu_destroy(owned);
+	}
+	menu_scene_destroy(menu);
+	struct menuitem *item, *next;
+	wl_list_for_each_safe(item, next, &menu->menuitems, link) {
+		item_destroy(item);
+	}
+	menu->size.width = menu->server->theme->menu_min_width;
+	menu->size.height = 0;
+	menu->measured = false;
+}
+
+/*
+ * Replace the content of a pipemenu with the output stored in @entry,
+ * or leave it empty if @entry is NULL. A pipemenu which is currently
+ * shown is re-created in place.
+ */
+static void
+pipemenu_fill(struct menu *pipemenu, struct pipe_cache_entry *entry)
+{
+	bool visible = pipemenu->scene_tree
+		&& pipemenu->scene_tree->node.enabled;
+
+	menu_clear(pipemenu);
+	pipemenu->pipe.serial = 0;
+	if (entry) {
+		parse_pipemenu(pipemenu, entry->output);
+		pipemenu->pipe.serial = entry->serial;
+
+		validate_menu(pipemenu);
+		struct menu *menu;
+		wl_list_for_each(menu, &pipemenu->server->menus, link) {
+			if (menu->pipe_owner == pipemenu) {
+				validate_menu(menu);
+			}
+		}
+	}
+
+	if (visible) {
+		menu_configure(pipemenu, pipemenu->anchor.x,
+			pipemenu->anchor.y, pipemenu->anchor.align);
+		menu_scene_create(pipemenu);
+		wlr_scene_node_set_enabled(&pipemenu->scene_tree->node, true);
+	}
+}
+
+/* Stop reading from the generator, which is reaped asynchronously */
+static void
+pipemenu_stop(struct menu *pipemenu, bool kill_generator)
+{
+	if (pipemenu->pipe.source) {
+		wl_event_source_remove(pipemenu->pipe.source);
+		pipemenu->pipe.source = NULL;
+		close(pipemenu->pipe.fd);
+	}
+	if (pipemenu->pipe.timer) {
+		wl_event_source_remove(pipemenu->pipe.timer);
+		pipemenu->pipe.timer = NULL;
+	}
+	if (pipemenu->pipe.pid > 0) {
+		if (kill_generator) {
+			kill(pipemenu->pipe.pid, SIGKILL);
+		}
+		spawn_reap_async(pipemenu->pipe.pid);
+		pipemenu->pipe.pid = 0;
+	}
+	zfree(pipemenu->pipe.output.buf);
+}
+
+static int
+handle_pipemenu_readable(int fd, uint32_t mask, void *data)
+{
+	struct menu *pipemenu = data;
+	char chunk[4096];
+	ssize_t n;
+
+	while ((n = read(fd, chunk, sizeof(chunk) - 1)) > 0) {
+		chunk[n] = '\0';
+		buf_add(&pipemenu->pipe.output, chunk);
+		if (pipemenu->pipe.output.len > PIPEMENU_MAX_SIZE) {
+			wlr_log(WLR_ERROR, "output from pipemenu '%s' too large",
+				pipemenu->execute);
+			pipemenu_stop(pipemenu, /* kill_generator */ true);
+			pipemenu_fill(pipemenu, NULL);
+			return 0;
+		}
+	}
+	if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+		/* Wait for more */
+		return 0;
+	}
+	if (n < 0) {
+		wlr_log_errno(WLR_ERROR, "failed to read from pipemenu '%s'",
+			pipemenu->execute);
+		pipemenu_stop(pipemenu, /* kill_generator */ true);
+		pipemenu_fill(pipemenu, NULL);
+		return 0;
+	}
+
+	/* End of file, the output is handed over to the cache */
+	char *output = pipemenu->pipe.output.buf;
+	pipemenu->pipe.output.buf = NULL;
+	pipemenu_stop(pipemenu, /* kill_generator */ false);
+	pipemenu_fill(pipemenu, pipe_cache_store(pipemenu->execute, output));
+	return 0;
+}
+
+static int
+handle_pipemenu_timeout(void *data)
+{
+	struct menu *pipemenu = data;
+	wlr_log(WLR_ERROR, "pipemenu '%s' timed out", pipemenu->execute);
+	pipemenu_stop(pipemenu, /* kill_generator */ true);
+	pipemenu_fill(pipemenu, NULL);
+	return 0;
+}
+
+static void
+pipemenu_start(struct menu *pipemenu)
+{
+	/* Show a placeholder until the generator has finished */
+	pipemenu_fill(pipemenu, NULL);
+	struct menuitem *item = item_create(pipemenu, _("Loading…"), false);
+	item->selectable = false;
+
+	int fd;
+	pid_t pid = spawn_piped(pipemenu->execute, &fd);
+	if (pid < 0) {
+		wlr_log(WLR_ERROR, "failed to run pipemenu '%s'",
+			pipemenu->execute);
+		pipemenu_fill(pipemenu, NULL);
+		return;
+	}
+
+	struct wl_event_loop *loop = pipemenu->server->wl_event_loop;
+	pipemenu->pipe.pid = pid;
+	pipemenu->pipe.fd = fd;
+	buf_init(&pipemenu->pipe.output);
+	pipemenu->pipe.source = wl_event_loop_add_fd(loop, fd,
+		WL_EVENT_READABLE, handle_pipemenu_readable, pipemenu);
+	pipemenu->pipe.timer = wl_event_loop_add_timer(loop,
+		handle_pipemenu_timeout, pipemenu);
+	wl_event_source_timer_update(pipemenu->pipe.timer,
+		PIPEMENU_TIMEOUT_MS);
+}
+
+/* Bring the content of a pipemenu up to date before it is shown */
+static void
+pipemenu_update(struct menu *pipemenu)
+{
+	if (pipemenu->pipe.pid > 0) {
+		/* Generator still running, keep showing the placeholder */
+		return;
+	}
+	struct pipe_cache_entry *entry = pipe_cache_find(pipemenu->execute);
+	if (pipe_cache_fresh(entry)) {
+		if (pipemenu->pipe.serial != entry->serial) {
+			pipemenu_fill(pipemenu, entry);
+		}
+		return;
+	}
+	pipemenu_start(pipemenu);
+}
+
+static void
+menu_destroy(struct menu *menu)
+{
+	pipemenu_stop(menu, /* kill_generator */ true);
+	menu_clear(menu);
+
+	/* Menus shared by several parents may still point here */
+	struct menu *iter;
+	wl_list_for_each(iter, &menu->server->menus, link) {
+		if (iter->parent == menu) {
+			iter->parent = NULL;
+		}
+	}
+	wl_list_remove(&menu->link);
+	free(menu->execute);
+	free(menu->id);
+	free(menu->label);
+	free(menu);
+}
+
 static void
 menu_hide_submenu(struct server *server, const char *id)
 {
@@ -676,8 +1174,11 @@ menu_hide_submenu(struct server *server, const char *id)
 		/* Re-position items vertically */
 		menu->size.height = 0;
 		wl_list_for_each(item, &menu->menuitems, link) {
-			wlr_scene_node_set_position(&item->tree->node, 0,
-				menu->size.height);
+			item->y = menu->size.height;
+			if (item->tree) {
+				wlr_scene_node_set_position(&item->tree->node,
+					0, item->y);
+			}
 			menu->size.height += item->height;
 		}
 	}
@@ -759,26 +1260,24 @@ menu_init(struct server *server)
 	parse_xml("menu.xml", server);
 	init_rootmenu(server);
 	init_windowmenu(server);
-	post_processing(server);
 	validate(server);
+
+	release_timer = wl_event_loop_add_timer(server->wl_event_loop,
+		handle_release_timeout, server);
 }
 
 void
 menu_finish(struct server *server)
 {
-	struct menu *menu, *tmp_menu;
-	wl_list_for_each_safe(menu, tmp_menu, &server->menus, link) {
-		struct menuitem *item, *next;
-		wl_list_for_each_safe(item, next, &menu->menuitems, link) {
-			item_destroy(item);
-		}
-		/**
-		 * Destroying the root node will destroy everything,
-		 * including node descriptors and scaled_font_buffers.
-		 */
-		wlr_scene_node_destroy(&menu->scene_tree->node);
-		wl_list_remove(&menu->link);
-		zfree(menu);
+	if (release_timer) {
+		wl_event_source_remove(release_timer);
+		release_timer = NULL;
+	}
+	/* Destroying a pipemenu also destroys the menus it defined */
+	while (!wl_list_empty(&server->menus)) {
+		struct menu *menu = wl_container_of(server->menus.next,
+			menu, link);
+		menu_destroy(menu);
 	}
 }
 
@@ -787,14 +1286,14 @@ static void
 menu_set_selection(struct menu *menu, struct menuitem *item)
 {
 	/* Clear old selection */
-	if (menu->selection.item) {
+	if (menu->selection.item && menu->selection.item->tree) {
 		wlr_scene_node_set_enabled(
 			&menu->selection.item->normal.tree->node, true);
 		wlr_scene_node_set_enabled(
 			&menu->selection.item->selected.tree->node, false);
 	}
 	/* Set new selection */
-	if (item) {
+	if (item && item->tree) {
 		wlr_scene_node_set_enabled(&item->normal.tree->node, false);
 		wlr_scene_node_set_enabled(&item->selected.tree->node, true);
 	}
@@ -807,8 +1306,10 @@ close_all_submenus(struct menu *menu)
 	struct menuitem *item;
 	wl_list_for_each(item, &menu->menuitems, link) {
 		if (item->submenu) {
-			wlr_scene_node_set_enabled(
-				&item->submenu->scene_tree->node, false);
+			if (item->submenu->scene_tree) {
+				wlr_scene_node_set_enabled(
+					&item->submenu->scene_tree->node, false);
+			}
 			close_all_submenus(item->submenu);
 		}
 	}
@@ -822,7 +1323,9 @@ menu_close(struct menu *menu)
 		wlr_log(WLR_ERROR, "Trying to close non exiting menu");
 		return;
 	}
-	wlr_scene_node_set_enabled(&menu->scene_tree->node, false);
+	if (menu->scene_tree) {
+		wlr_scene_node_set_enabled(&menu->scene_tree->node, false);
+	}
 	menu_set_selection(menu, NULL);
 	if (menu->selection.menu) {
 		menu_close(menu->selection.menu);
@@ -839,7 +1342,11 @@ menu_open(struct menu *menu, int x, int y)
 	}
 	close_all_submenus(menu);
 	menu_set_selection(menu, NULL);
+	if (menu->execute) {
+		pipemenu_update(menu);
+	}
 	menu_configure(menu, x, y, LAB_MENU_OPEN_AUTO);
+	menu_scene_create(menu);
 	wlr_scene_node_set_enabled(&menu->scene_tree->node, true);
 	menu->server->menu_current = menu;
 	menu->server->input_mode = LAB_INPUT_STATE_MENU;
@@ -867,6 +1374,14 @@ menu_process_item_selection(struct menuitem *item)
 		/* Ensure the submenu has its parent set correctly */
 		item->submenu->parent = item->parent;
 		/* And open the new submenu tree */
+		if (item->submenu->execute) {
+			struct menu *pipemenu = item->submenu;
+			pipemenu_update(pipemenu);
+			/* Its size may have changed since it was positioned */
+			menu_configure(pipemenu, pipemenu->anchor.x,
+				pipemenu->anchor.y, pipemenu->anchor.align);
+		}
+		menu_scene_create(item->submenu);
 		wlr_scene_node_set_enabled(
 			&item->submenu->scene_tree->node, true);
 	}
@@ -941,6 +1456,7 @@ menu_execute_item(struct menuitem *item)
 	 */
 	menu_close(item->parent->server->menu_current);
 	item->parent->server->menu_current = NULL;
+	schedule_release();
 
 	return true;
 }
@@ -1035,6 +1551,7 @@ menu_close_root(struct server *server)
 	if (server->menu_current) {
 		menu_close(server->menu_current);
 		server->menu_current = NULL;
+		schedule_release();
 	}
 	server->input_mode = LAB_INPUT_STATE_PASSTHROUGH;
 }
@@ -11,15 +11,21 @@
 #include "common/buf.h"
 #include "common/font.h"
 #include "common/graphic-helpers.h"
+#include "common/macros.h"
+#include "common/mem.h"
+#include "common/scaled_font_buffer.h"
 #include "common/scene-helpers.h"
 #include "config/rcxml.h"
 #include "labwc.h"
 #include "theme.h"
+#include "trace.h"
 #include "node.h"
 #include "view.h"
 #include "window-rules.h"
 #include "workspaces.h"
 
+static void rows_finish(struct osd_state *osd_state);
+
 /* is title different from app_id/class? */
 static int
 is_title_different(struct view *view)
@@ -63,6 +69,8 @@ destroy_osd_nodes(struct output *output)
 	wl_list_for_each_safe(child, next, children, link) {
 		wlr_scene_node_destroy(child);
 	}
+	output->osd_scene.tree = NULL;
+	output->osd_scene.highlight = NULL;
 }
 
 static void
@@ -136,9 +144,33 @@ osd_on_view_destroy(struct view *view)
 	}
 }
 
+static void
+handle_update_idle(void *data)
+{
+	struct server *server = data;
+	server->osd_state.update_idle = NULL;
+	if (server->osd_state.cycle_view) {
+		osd_update(server);
+	}
+}
+
+void
+osd_schedule_update(struct server *server)
+{
+	if (!server->osd_state.cycle_view || server->osd_state.update_idle) {
+		return;
+	}
+	server->osd_state.update_idle = wl_event_loop_add_idle(
+		server->wl_event_loop, handle_update_idle, server);
+}
+
 void
 osd_finish(struct server *server)
 {
+	if (server->osd_state.update_idle) {
+		wl_event_source_remove(server->osd_state.update_idle);
+		server->osd_state.update_idle = NULL;
+	}
 	server->osd_state.preview_node = NULL;
 	server->osd_state.preview_anchor = NULL;
 
@@ -147,6 +179,7 @@ osd_finish(struct server *server)
 		destroy_osd_nodes(output);
 		wlr_scene_node_set_enabled(&output->osd_tree->node, false);
 	}
+	rows_finish(&server->osd_state);
 	if (server->osd_state.preview_outline) {
 		/* Destroy the whole multi_rect so we can easily react to new themes */
 		wlr_scene_node_destroy(&server->osd_state.preview_outline->tree->node);
@@ -256,191 +289,379 @@ get_title(struct view *view)
 	}
 }
 
-static void
-render_osd(struct server *server, cairo_t *cairo, int w, int h,
-		struct wl_list *node_list, bool show_workspace,
-		const char *workspace_name, struct wl_array *views)
+/*
+ * A row of the window switcher, rasterised once for each distinct output
+ * scale and shared by the OSD scene trees of all outputs. Rows are only
+ * kept while cycling and dropped by osd_finish().
+ */
+struct osd_row {
+	struct view *view;
+	char *text; /* field contents, to detect changes */
+	struct wl_array buffers; /* struct osd_row_buffer */
+};
+
+struct osd_row_buffer {
+	double scale;
+	struct lab_data_buffer *buffer;
+};
+
+/* This is the width of the area available for text fields */
+static int
+get_available_width(struct theme *theme)
 {
-	struct view *cycle_view = server->osd_state.cycle_view;
-	struct theme *theme = server->theme;
+	return theme->osd_window_switcher_width
+		- 2 * theme->osd_border_width
+		- 2 * theme->osd_window_switcher_padding
+		- 2 * theme->osd_window_switcher_item_active_border_width;
+}
 
-	cairo_surface_t *surf = cairo_get_target(cairo);
+static const char *
+get_field_text(struct view *view, struct window_switcher_field *field)
+{
+	switch (field->content) {
+	case LAB_FIELD_TYPE:
+		return get_type(view);
+	case LAB_FIELD_IDENTIFIER:
+		return get_app_id(view);
+	case LAB_FIELD_TITLE:
+		return get_title(view);
+	default:
+		return "";
+	}
+}
 
-	/* Draw background */
-	set_cairo_color(cairo, theme->osd_bg_color);
-	cairo_rectangle(cairo, 0, 0, w, h);
-	cairo_fill(cairo);
+static char *
+row_text(struct view *view)
+{
+	struct buf buf;
+	buf_init(&buf);
+	struct window_switcher_field *field;
+	wl_list_for_each(field, &rc.window_switcher.fields, link) {
+		const char *text = get_field_text(view, field);
+		buf_add(&buf, text ? text : "");
+		/* Unit separator */
+		buf_add(&buf, "\x1f");
+	}
+	return buf.buf;
+}
 
-	/* Draw border */
-	set_cairo_color(cairo, theme->osd_border_color);
-	struct wlr_fbox fbox = {
-		.width = w,
-		.height = h,
-	};
-	draw_cairo_border(cairo, fbox, theme->osd_border_width);
+static void
+row_drop_buffers(struct osd_row *row)
+{
+	struct osd_row_buffer *entry;
+	wl_array_for_each(entry, &row->buffers) {
+		/* Freed once the scene nodes of all outputs let go of it */
+		wlr_buffer_drop(&entry->buffer->base);
+	}
+	wl_array_release(&row->buffers);
+	wl_array_init(&row->buffers);
+}
+
+static void
+row_destroy(struct osd_row *row)
+{
+	row_drop_buffers(row);
+	free(row->text);
+	free(row);
+}
+
+static struct lab_data_buffer *
+row_render(struct osd_row *row, struct theme *theme, double scale)
+{
+	/*
+	 *    OSD border
+	 * +---------------------------------+
+	 * |                                 |
+	 * |  item border                    |
+	 * |+-------------------------------+|
+	 * ||                               ||
+	 * ||padding between each field     ||
+	 * ||| field-1 | field-2 | field-n |||
+	 * ||                               ||
+	 * ||                               ||
+	 * |+-------------------------------+|
+	 * |                                 |
+	 * |                                 |
+	 * +---------------------------------+
+	 *
+	 * The buffer only covers the fields, starting at field-1.
+	 */
+	int available_width = get_available_width(theme);
+	int width = MAX(available_width
+		- theme->osd_window_switcher_item_padding_x, 1);
+	int height = font_height(&rc.font_osd);
+
+	struct lab_data_buffer *buffer =
+		buffer_create_cairo(width, height, scale, true);
+	if (!buffer) {
+		wlr_log(WLR_ERROR, "Failed to allocate cairo buffer for the window switcher");
+		return NULL;
+	}
 
-	/* Set up text rendering */
+	cairo_t *cairo = buffer->cairo;
 	set_cairo_color(cairo, theme->osd_label_text_color);
 	PangoLayout *layout = pango_cairo_create_layout(cairo);
 	pango_layout_set_ellipsize(layout, PANGO_ELLIPSIZE_END);
-
 	PangoFontDescription *desc = font_to_pango_desc(&rc.font_osd);
 	pango_layout_set_font_description(layout, desc);
-
+	pango_font_description_free(desc);
 	pango_cairo_update_layout(cairo, layout);
 
-	int y = theme->osd_border_width + theme->osd_window_switcher_padding;
-
-	/* Draw workspace indicator */
-	if (show_workspace) {
-		/* Center workspace indicator on the x axis */
-		int x = font_width(&rc.font_osd, workspace_name);
-		x = (theme->osd_window_switcher_width - x) / 2;
-		cairo_move_to(cairo, x, y + theme->osd_window_switcher_item_active_border_width);
-		PangoWeight weight = pango_font_description_get_weight(desc);
-		pango_font_description_set_weight(desc, PANGO_WEIGHT_BOLD);
-		pango_layout_set_font_description(layout, desc);
-		pango_layout_set_text(layout, workspace_name, -1);
+	int x = 0;
+	int nr_fields = wl_list_length(&rc.window_switcher.fields);
+	struct window_switcher_field *field;
+	wl_list_for_each(field, &rc.window_switcher.fields, link) {
+		const char *text = get_field_text(row->view, field);
+		int field_width = (available_width - (nr_fields + 1)
+			* theme->osd_window_switcher_item_padding_x)
+			* field->width / 100.0;
+		cairo_move_to(cairo, x, 0);
+		pango_layout_set_width(layout, field_width * PANGO_SCALE);
+		pango_layout_set_text(layout, text ? text : "", -1);
 		pango_cairo_show_layout(cairo, layout);
-		pango_font_description_set_weight(desc, weight);
-		pango_layout_set_font_description(layout, desc);
-		y += theme->osd_window_switcher_item_height;
+		x += field_width + theme->osd_window_switcher_item_padding_x;
 	}
-	pango_font_description_free(desc);
+	g_object_unref(layout);
 
-	struct buf buf;
-	buf_init(&buf);
+	cairo_surface_flush(cairo_get_target(cairo));
+	return buffer;
+}
 
-	/* This is the width of the area available for text fields */
-	int available_width = w - 2 * theme->osd_border_width
-		- 2 * theme->osd_window_switcher_padding
-		- 2 * theme->osd_window_switcher_item_active_border_width;
+static struct lab_data_buffer *
+row_get_buffer(struct osd_row *row, struct theme *theme, double scale)
+{
+	struct osd_row_buffer *entry;
+	wl_array_for_each(entry, &row->buffers) {
+		if (entry->scale == scale) {
+			return entry->buffer;
+		}
+	}
+
+	struct lab_data_buffer *buffer = row_render(row, theme, scale);
+	if (!buffer) {
+		return NULL;
+	}
+	entry = wl_array_add(&row->buffers, sizeof(*entry));
+	if (!entry) {
+		wlr_buffer_drop(&buffer->base);
+		return NULL;
+	}
+	entry->scale = scale;
+	entry->buffer = buffer;
+	return buffer;
+}
+
+static void
+rows_finish(struct osd_state *osd_state)
+{
+	struct osd_row **row;
+	wl_array_for_each(row, &osd_state->rows) {
+		row_destroy(*row);
+	}
+	wl_array_release(&osd_state->rows);
+	wl_array_init(&osd_state->rows);
+}
 
-	/* Draw text for each node */
+/*
+ * Bring the cached rows in line with @views, re-using rows of views that
+ * were shown before. Returns true if the rows need to be laid out again,
+ * that is if views were added, removed or reordered or if their content
+ * changed.
+ */
+static bool
+rows_update(struct osd_state *osd_state, struct wl_array *views)
+{
+	struct wl_array *old_rows = &osd_state->rows;
+	size_t nr_old_rows = wl_array_len(old_rows);
+	bool changed = nr_old_rows != wl_array_len(views);
+
+	struct wl_array rows;
+	wl_array_init(&rows);
+
+	size_t index = 0;
 	struct view **view;
 	wl_array_for_each(view, views) {
-		/*
-		 *    OSD border
-		 * +---------------------------------+
-		 * |                                 |
-		 * |  item border                    |
-		 * |+-------------------------------+|
-		 * ||                               ||
-		 * ||padding between each field     ||
-		 * ||| field-1 | field-2 | field-n |||
-		 * ||                               ||
-		 * ||                               ||
-		 * |+-------------------------------+|
-		 * |                                 |
-		 * |                                 |
-		 * +---------------------------------+
-		 */
-		int x = theme->osd_border_width
-			+ theme->osd_window_switcher_padding
-			+ theme->osd_window_switcher_item_active_border_width
-			+ theme->osd_window_switcher_item_padding_x;
-
-		int nr_fields = wl_list_length(&rc.window_switcher.fields);
-		struct window_switcher_field *field;
-		wl_list_for_each(field, &rc.window_switcher.fields, link) {
-			buf.len = 0;
-			cairo_move_to(cairo, x, y
-				+ theme->osd_window_switcher_item_padding_y
-				+ theme->osd_window_switcher_item_active_border_width);
-
-			switch (field->content) {
-			case LAB_FIELD_TYPE:
-				buf_add(&buf, get_type(*view));
-				break;
-			case LAB_FIELD_IDENTIFIER:
-				buf_add(&buf, get_app_id(*view));
-				break;
-			case LAB_FIELD_TITLE:
-				buf_add(&buf, get_title(*view));
-				break;
-			default:
+		struct osd_row *row = NULL;
+		struct osd_row **old = old_rows->data;
+		for (size_t i = 0; i < nr_old_rows; i++) {
+			if (old[i] && old[i]->view == *view) {
+				changed |= i != index;
+				row = old[i];
+				old[i] = NULL;
 				break;
 			}
-			int field_width = (available_width - (nr_fields + 1)
-				* theme->osd_window_switcher_item_padding_x)
-				* field->width / 100.0;
-			pango_layout_set_width(layout, field_width * PANGO_SCALE);
-			pango_layout_set_text(layout, buf.buf, -1);
-			pango_cairo_show_layout(cairo, layout);
-			x += field_width + theme->osd_window_switcher_item_padding_x;
+		}
+		if (!row) {
+			row = znew(*row);
+			row->view = *view;
+			wl_array_init(&row->buffers);
+			changed = true;
 		}
 
-		if (*view == cycle_view) {
-			/* Highlight current window */
-			struct wlr_fbox fbox = {
-				.x = theme->osd_border_width + theme->osd_window_switcher_padding,
-				.y = y,
-				.width = theme->osd_window_switcher_width
-					- 2 * theme->osd_border_width
-					- 2 * theme->osd_window_switcher_padding,
-				.height = theme->osd_window_switcher_item_height,
-			};
-			draw_cairo_border(cairo, fbox,
-				theme->osd_window_switcher_item_active_border_width);
-			cairo_stroke(cairo);
+		char *text = row_text(*view);
+		if (!row->text || strcmp(row->text, text)) {
+			free(row->text);
+			row->text = text;
+			row_drop_buffers(row);
+			changed = true;
+		} else {
+			free(text);
 		}
 
-		y += theme->osd_window_switcher_item_height;
+		struct osd_row **entry = wl_array_add(&rows, sizeof(*entry));
+		if (!entry) {
+			wlr_log(WLR_ERROR, "wl_array_add(): out of memory");
+			row_destroy(row);
+			continue;
+		}
+		*entry = row;
+		index++;
 	}
-	free(buf.buf);
-	g_object_unref(layout);
 
-	cairo_surface_flush(surf);
+	/* Drop rows of views which are no longer shown */
+	struct osd_row **row;
+	wl_array_for_each(row, old_rows) {
+		if (*row) {
+			row_destroy(*row);
+		}
+	}
+	wl_array_release(old_rows);
+	osd_state->rows = rows;
+	return changed;
+}
+
+static struct wlr_scene_tree *
+create_highlight(struct wlr_scene_tree *parent, struct theme *theme)
+{
+	int line_width = theme->osd_window_switcher_item_active_border_width;
+	int w = theme->osd_window_switcher_width
+		- 2 * theme->osd_border_width
+		- 2 * theme->osd_window_switcher_padding;
+	int h = theme->osd_window_switcher_item_height;
+	float *color = theme->osd_label_text_color;
+
+	struct wlr_scene_tree *tree = wlr_scene_tree_create(parent);
+	wlr_scene_rect_create(tree, w, line_width, color);
+	struct wlr_scene_rect *rect =
+		wlr_scene_rect_create(tree, w, line_width, color);
+	wlr_scene_node_set_position(&rect->node, 0, h - line_width);
+	rect = wlr_scene_rect_create(tree, line_width,
+		h - 2 * line_width, color);
+	wlr_scene_node_set_position(&rect->node, 0, line_width);
+	rect = wlr_scene_rect_create(tree, line_width,
+		h - 2 * line_width, color);
+	wlr_scene_node_set_position(&rect->node, w - line_width, line_width);
+	return tree;
 }
 
+/* Create the OSD scene tree of one output from the cached rows */
 static void
-display_osd(struct output *output)
+build_osd(struct output *output, struct wl_array *rows)
 {
 	struct server *server = output->server;
 	struct theme *theme = server->theme;
-	struct wl_list *node_list =
-		&server->workspace_current->tree->children;
 	bool show_workspace = wl_list_length(&rc.workspace_config.workspaces) > 1;
 	const char *workspace_name = server->workspace_current->name;
+	float scale = output->wlr_output->scale;
 
-	struct wl_array views;
-	wl_array_init(&views);
-	view_array_append(server, &views,
-		LAB_VIEW_CRITERIA_CURRENT_WORKSPACE
-		| LAB_VIEW_CRITERIA_NO_ALWAYS_ON_TOP
-		| LAB_VIEW_CRITERIA_NO_SKIP_WINDOW_SWITCHER);
+	destroy_osd_nodes(output);
 
-	float scale = output->wlr_output->scale;
+	int border_width = theme->osd_border_width;
 	int w = theme->osd_window_switcher_width;
-	int h = wl_array_len(&views) * rc.theme->osd_window_switcher_item_height
-		+ 2 * rc.theme->osd_border_width
-		+ 2 * rc.theme->osd_window_switcher_padding;
+	int h = wl_array_len(rows) * theme->osd_window_switcher_item_height
+		+ 2 * border_width
+		+ 2 * theme->osd_window_switcher_padding;
 	if (show_workspace) {
 		/* workspace indicator */
 		h += theme->osd_window_switcher_item_height;
 	}
 
-	/* Reset buffer */
-	if (output->osd_buffer) {
-		wlr_buffer_drop(&output->osd_buffer->base);
+	struct wlr_scene_tree *tree = wlr_scene_tree_create(output->osd_tree);
+	output->osd_scene.tree = tree;
+	output->osd_scene.height = h;
+
+	/* Border and background */
+	wlr_scene_rect_create(tree, w, h, theme->osd_border_color);
+	struct wlr_scene_rect *bg = wlr_scene_rect_create(tree,
+		MAX(w - 2 * border_width, 0), MAX(h - 2 * border_width, 0),
+		theme->osd_bg_color);
+	wlr_scene_node_set_position(&bg->node, border_width, border_width);
+
+	int y = border_width + theme->osd_window_switcher_padding;
+
+	/* Workspace indicator */
+	if (show_workspace) {
+		struct font font = rc.font_osd;
+		font.weight = FONT_WEIGHT_BOLD;
+		struct scaled_font_buffer *font_buffer =
+			scaled_font_buffer_create(tree);
+		if (font_buffer) {
+			scaled_font_buffer_update(font_buffer, workspace_name,
+				w, &font, theme->osd_label_text_color, NULL);
+			/* Center workspace indicator on the x axis */
+			wlr_scene_node_set_position(&font_buffer->scene_buffer->node,
+				(w - font_buffer->width) / 2,
+				y + theme->osd_window_switcher_item_active_border_width);
+		}
+		y += theme->osd_window_switcher_item_height;
 	}
-	output->osd_buffer = buffer_create_cairo(w, h, scale, true);
-	if (!output->osd_buffer) {
-		wlr_log(WLR_ERROR, "Failed to allocate cairo buffer for the window switcher");
-		return;
+	output->osd_scene.first_row_y = y;
+
+	int x = border_width
+		+ theme->osd_window_switcher_padding
+		+ theme->osd_window_switcher_item_active_border_width
+		+ theme->osd_window_switcher_item_padding_x;
+	struct osd_row **row;
+	wl_array_for_each(row, rows) {
+		struct lab_data_buffer *buffer =
+			row_get_buffer(*row, theme, scale);
+		if (buffer) {
+			struct wlr_scene_buffer *scene_buffer =
+				wlr_scene_buffer_create(tree, &buffer->base);
+			wlr_scene_buffer_set_dest_size(scene_buffer,
+				buffer->unscaled_width, buffer->unscaled_height);
+			wlr_scene_node_set_position(&scene_buffer->node, x, y
+				+ theme->osd_window_switcher_item_padding_y
+				+ theme->osd_window_switcher_item_active_border_width);
+		}
+		y += theme->osd_window_switcher_item_height;
 	}
 
-	/* Render OSD image */
-	cairo_t *cairo = output->osd_buffer->cairo;
-	render_osd(server, cairo, w, h, node_list, show_workspace,
-		workspace_name, &views);
-	wl_array_release(&views);
+	output->osd_scene.highlight = create_highlight(tree, theme);
+}
 
-	struct wlr_scene_buffer *scene_buffer = wlr_scene_buffer_create(
-		output->osd_tree, &output->osd_buffer->base);
-	wlr_scene_buffer_set_dest_size(scene_buffer, w, h);
+static void
+display_osd(struct output *output, bool relayout)
+{
+	struct server *server = output->server;
+	struct theme *theme = server->theme;
+	struct wl_array *rows = &server->osd_state.rows;
+
+	if (relayout || !output->osd_scene.tree) {
+		build_osd(output, rows);
+	}
+
+	/* Highlight current window */
+	int index = 0;
+	bool found = false;
+	struct osd_row **row;
+	wl_array_for_each(row, rows) {
+		if ((*row)->view == server->osd_state.cycle_view) {
+			found = true;
+			break;
+		}
+		index++;
+	}
+	struct wlr_scene_node *highlight = &output->osd_scene.highlight->node;
+	wlr_scene_node_set_enabled(highlight, found);
+	wlr_scene_node_set_position(highlight,
+		theme->osd_border_width + theme->osd_window_switcher_padding,
+		output->osd_scene.first_row_y
+			+ index * theme->osd_window_switcher_item_height);
 
 	/* Center OSD */
+	int w = theme->osd_window_switcher_width;
+	int h = output->osd_scene.height;
 	struct wlr_box output_box;
 	wlr_output_layout_get_box(output->server->output_layout,
 		output->wlr_output, &output_box);
@@ -448,16 +669,14 @@ display_osd(struct output *output)
 		- w / 2 + output_box.x;
 	int ly = output->usable_area.y + output->usable_area.height / 2
 		- h / 2 + output_box.y;
-	wlr_scene_node_set_position(&scene_buffer->node, lx, ly);
+	wlr_scene_node_set_position(&output->osd_scene.tree->node, lx, ly);
 	wlr_scene_node_set_enabled(&output->osd_tree->node, true);
-
-	/* Update cursor, in case it is within the area covered by OSD */
-	cursor_update_focus(server);
 }
 
 void
 osd_update(struct server *server)
 {
+	TRACE_SCOPE("osd_update");
 	struct wl_list *node_list =
 		&server->workspace_current->tree->children;
 
@@ -467,14 +686,32 @@ osd_update(struct server *server)
 	}
 
 	if (rc.window_switcher.show && rc.theme->osd_window_switcher_width > 0) {
-		/* Display the actual OSD */
+		/*
+		 * Display the actual OSD. Unless the list of views or their
+		 * titles changed, only the highlight needs to be moved.
+		 */
+		struct wl_array views;
+		wl_array_init(&views);
+		view_array_append(server, &views,
+			LAB_VIEW_CRITERIA_CURRENT_WORKSPACE
+			| LAB_VIEW_CRITERIA_NO_ALWAYS_ON_TOP
+			| LAB_VIEW_CRITERIA_NO_SKIP_WINDOW_SWITCHER);
+		bool relayout = rows_update(&server->osd_state, &views);
+		wl_array_release(&views);
+
 		struct output *output;
 		wl_list_for_each(output, &server->outputs, link) {
-			destroy_osd_nodes(output);
 			if (output_is_usable(output)) {
-				display_osd(output);
+				display_osd(output, relayout);
+			} else {
+				destroy_osd_nodes(output);
 			}
 		}
+
+		/* Update cursor, in case it is within the area covered by OSD */
+		if (relayout) {
+			cursor_update_focus(server);
+		}
 	}
 
 	/* Outline current window */
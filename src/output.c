@@ -20,10 +20,12 @@
 #include "common/macros.h"
 #include "common/mem.h"
 #include "common/scene-helpers.h"
+#include "frame-stats.h"
 #include "labwc.h"
 #include "layers.h"
 #include "node.h"
 #include "regions.h"
+#include "trace.h"
 #include "view.h"
 #include "xwayland.h"
 
@@ -34,6 +36,7 @@ output_frame_notify(struct wl_listener *listener, void *data)
 	 * This function is called every time an output is ready to display a
 	 * frame - which is typically at 60 Hz.
 	 */
+	TRACE_SCOPE("output_frame_notify");
 	struct output *output = wl_container_of(listener, output, frame);
 	if (!output_is_usable(output)) {
 		return;
@@ -41,6 +44,7 @@ output_frame_notify(struct wl_listener *listener, void *data)
 
 	struct wlr_output *wlr_output = output->wlr_output;
 	struct server *server = output->server;
+	struct frame_stats *stats = &output->frame_stats;
 
 	if (output->gamma_lut_changed) {
 		struct wlr_output_state pending;
@@ -58,21 +62,46 @@ output_frame_notify(struct wl_listener *listener, void *data)
 		}
 
 		if (!wlr_output_commit_state(output->wlr_output, &pending)) {
+			stats->failures++;
 			wlr_gamma_control_v1_send_failed_and_destroy(gamma_control);
 			wlr_output_state_finish(&pending);
 			return;
 		}
 
+		stats->gamma_commits++;
 		wlr_damage_ring_rotate(&output->scene_output->damage_ring);
 		wlr_output_state_finish(&pending);
 		return;
 	}
 
-	wlr_scene_output_commit(output->scene_output, NULL);
+	/* Pace interactive resize to the refresh rate */
+	struct view *grabbed = server->grabbed_view;
+	if (grabbed && grabbed->output == output
+			&& server->input_mode == LAB_INPUT_STATE_RESIZE) {
+		interactive_resize_flush(grabbed);
+	}
+
+	/* The damage is consumed by the commit, so measure it first */
+	if (wlr_scene_output_needs_frame(output->scene_output)) {
+		int damage = frame_stats_damage(output->scene_output);
+		uint64_t start = frame_stats_now();
+		bool success;
+		{
+			TRACE_SCOPE("wlr_scene_output_commit");
+			success = wlr_scene_output_commit(output->scene_output,
+				NULL);
+		}
+		frame_stats_add(stats, frame_stats_now() - start, damage,
+			success);
+	} else {
+		stats->skipped++;
+	}
 
 	struct timespec now = { 0 };
 	clock_gettime(CLOCK_MONOTONIC, &now);
 	wlr_scene_output_send_frame_done(output->scene_output, &now);
+
+	frame_stats_overlay_update(output);
 }
 
 static void
@@ -80,6 +109,7 @@ output_destroy_notify(struct wl_listener *listener, void *data)
 {
 	struct output *output = wl_container_of(listener, output, destroy);
 	regions_evacuate_output(output);
+	frame_stats_overlay_destroy(output);
 	regions_destroy(&output->server->seat, &output->regions);
 	wl_list_remove(&output->link);
 	wl_list_remove(&output->frame.link);
@@ -97,12 +127,9 @@ output_destroy_notify(struct wl_listener *listener, void *data)
 		output->workspace_osd = NULL;
 	}
 
-	struct view *view;
-	struct server *server = output->server;
-	wl_list_for_each(view, &server->views, link) {
-		if (view->output == output) {
-			view_on_output_destroy(view);
-		}
+	struct view *view, *tmp;
+	wl_list_for_each_safe(view, tmp, &output->views, output_link) {
+		view_on_output_destroy(view);
 	}
 
 	/*
@@ -279,6 +306,7 @@ new_output_notify(struct wl_listener *listener, void *data)
 	wl_signal_add(&wlr_output->events.request_state, &output->request_state);
 
 	wl_list_init(&output->regions);
+	wl_list_init(&output->views);
 
 	/*
 	 * Create layer-trees (background, bottom, top and overlay) and
@@ -652,14 +680,25 @@ update_usable_area(struct output *output)
 	layers_arrange(output);
 
 #if HAVE_XWAYLAND
-	struct view *view;
-	wl_list_for_each(view, &output->server->views, link) {
-		if (view->mapped && view->type == LAB_XWAYLAND_VIEW) {
-			xwayland_adjust_usable_area(view,
-				output->server->output_layout,
-				output->wlr_output, &output->usable_area);
-		}
-	}
+	struct server *server = output->server;
+	if (output->strut_cache.valid
+			&& output->strut_cache.strut_serial == server->strut_serial
+			&& wlr_box_equal(&output->strut_cache.layers_area,
+				&output->usable_area)) {
+		output->usable_area = output->strut_cache.usable_area;
+		return !wlr_box_equal(&old, &output->usable_area);
+	}
+
+	output->strut_cache.layers_area = output->usable_area;
+	struct xwayland_view *xwayland_view;
+	wl_list_for_each(xwayland_view, &server->strut_views, strut_link) {
+		xwayland_adjust_usable_area(&xwayland_view->base,
+			server->output_layout, output->wlr_output,
+			&output->usable_area);
+	}
+	output->strut_cache.usable_area = output->usable_area;
+	output->strut_cache.strut_serial = server->strut_serial;
+	output->strut_cache.valid = true;
 #endif
 	return !wlr_box_equal(&old, &output->usable_area);
 }
@@ -672,7 +711,8 @@ output_update_usable_area(struct output *output)
 #if HAVE_XWAYLAND
 		xwayland_update_workarea(output->server);
 #endif
-		desktop_arrange_all_views(output->server);
+		output->layer_stats.view_arranges++;
+		desktop_arrange_output_views(output);
 	}
 }
 
@@ -683,6 +723,12 @@ output_update_all_usable_areas(struct server *server, bool layout_changed)
 	struct output *output;
 
 	wl_list_for_each(output, &server->outputs, link) {
+#if HAVE_XWAYLAND
+		if (layout_changed) {
+			/* Struts are relative to the layout bounding box */
+			output->strut_cache.valid = false;
+		}
+#endif
 		if (update_usable_area(output)) {
 			usable_area_changed = true;
 			regions_update_geometry(output);
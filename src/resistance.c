@@ -1,4 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-only
+#include <stdlib.h>
+#include <wlr/util/log.h>
+#include "common/macros.h"
 #include "config/rcxml.h"
 #include "labwc.h"
 #include "resistance.h"
@@ -32,8 +35,8 @@ is_within_resistance_range(struct edges view, struct edges target,
 	}
 }
 
-void
-resistance_move_apply(struct view *view, double *x, double *y)
+static void
+screen_move_apply(struct view *view, double *x, double *y)
 {
 	struct server *server = view->server;
 	struct wlr_box mgeom, intersection;
@@ -102,8 +105,8 @@ resistance_move_apply(struct view *view, double *x, double *y)
 	}
 }
 
-void
-resistance_resize_apply(struct view *view, struct wlr_box *new_view_geo)
+static void
+screen_resize_apply(struct view *view, struct wlr_box *new_view_geo)
 {
 	struct server *server = view->server;
 	struct output *output;
@@ -186,3 +189,263 @@ resistance_resize_apply(struct view *view, struct wlr_box *new_view_geo)
 		flags.bottom = 0;
 	}
 }
+
+/*
+ * Edges of other windows, snapshot at the start of an interactive move or
+ * resize so that motion events do not need to look at every view. There
+ * is one array per edge of the grabbed view, each holding the opposite
+ * edges of the other windows sorted by position. For example, the left
+ * edge of the grabbed view resists against the right edges of others.
+ */
+enum resist_side {
+	RESIST_LEFT = 0,
+	RESIST_TOP,
+	RESIST_RIGHT,
+	RESIST_BOTTOM,
+	RESIST_SIDE_COUNT
+};
+
+struct window_edge {
+	int pos;
+	/* Extent along the other axis, edges only resist if it overlaps */
+	int start;
+	int end;
+};
+
+static struct wl_array window_edges[RESIST_SIDE_COUNT];
+
+static void
+window_edge_add(enum resist_side side, int pos, int start, int end)
+{
+	struct window_edge *edge = wl_array_add(&window_edges[side],
+		sizeof(*edge));
+	if (!edge) {
+		wlr_log(WLR_ERROR, "wl_array_add(): out of memory");
+		return;
+	}
+	*edge = (struct window_edge){ .pos = pos, .start = start, .end = end };
+}
+
+static int
+window_edge_cmp(const void *a, const void *b)
+{
+	const struct window_edge *edge_a = a;
+	const struct window_edge *edge_b = b;
+	return (edge_a->pos > edge_b->pos) - (edge_a->pos < edge_b->pos);
+}
+
+void
+resistance_begin(struct view *view)
+{
+	resistance_finish();
+	if (!rc.window_edge_strength) {
+		return;
+	}
+
+	struct view *v;
+	for_each_view_on_workspace(v, view->server->workspace_current) {
+		if (v == view || v->minimized || !view_is_focusable(v)) {
+			continue;
+		}
+		struct border margin = ssd_get_margin(v->ssd);
+		struct edges e = {
+			.left = v->current.x - margin.left,
+			.top = v->current.y - margin.top,
+			.right = v->current.x + v->current.width + margin.right,
+			.bottom = v->current.y + v->current.height + margin.bottom,
+		};
+		window_edge_add(RESIST_LEFT, e.right, e.top, e.bottom);
+		window_edge_add(RESIST_RIGHT, e.left, e.top, e.bottom);
+		window_edge_add(RESIST_TOP, e.bottom, e.left, e.right);
+		window_edge_add(RESIST_BOTTOM, e.top, e.left, e.right);
+	}
+
+	for (enum resist_side side = 0; side < RESIST_SIDE_COUNT; side++) {
+		qsort(window_edges[side].data,
+			window_edges[side].size / sizeof(struct window_edge),
+			sizeof(struct window_edge), window_edge_cmp);
+	}
+}
+
+void
+resistance_finish(void)
+{
+	for (enum resist_side side = 0; side < RESIST_SIDE_COUNT; side++) {
+		wl_array_release(&window_edges[side]);
+		wl_array_init(&window_edges[side]);
+	}
+}
+
+/* Index of the first edge with a position not less than pos */
+static size_t
+window_edges_lower_bound(enum resist_side side, int pos)
+{
+	struct window_edge *edges = window_edges[side].data;
+	size_t lo = 0, hi = window_edges[side].size / sizeof(*edges);
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (edges[mid].pos < pos) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/*
+ * Find the first edge that an edge of the grabbed view would cross when
+ * going from view_pos to target_pos, as long as target_pos is still within
+ * strength pixels of it. Only edges of windows overlapping [start, end)
+ * along the other axis are considered. Same rules as for output edges,
+ * see is_within_resistance_range().
+ */
+static bool
+window_edge_find(enum resist_side side, int view_pos, int target_pos,
+		int start, int end, int *pos)
+{
+	struct window_edge *edges = window_edges[side].data;
+	size_t len = window_edges[side].size / sizeof(*edges);
+	int strength = rc.window_edge_strength;
+
+	if (side == RESIST_LEFT || side == RESIST_TOP) {
+		/* Moving towards lower coordinates, nearest edge is the highest */
+		int lo = target_pos + 1;
+		int hi = MIN(view_pos, target_pos + strength);
+		for (size_t i = window_edges_lower_bound(side, hi + 1);
+				i-- > 0 && edges[i].pos >= lo;) {
+			if (edges[i].start < end && edges[i].end > start) {
+				*pos = edges[i].pos;
+				return true;
+			}
+		}
+	} else {
+		int lo = MAX(view_pos, target_pos - strength);
+		int hi = target_pos - 1;
+		for (size_t i = window_edges_lower_bound(side, lo);
+				i < len && edges[i].pos <= hi; i++) {
+			if (edges[i].start < end && edges[i].end > start) {
+				*pos = edges[i].pos;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+static void
+window_move_apply(struct view *view, double *x, double *y)
+{
+	struct wlr_box vgeom = view->current;
+	struct border border = ssd_get_margin(view->ssd);
+	int pos;
+
+	/* Same +1 as for output edges so that windows can be moved apart */
+	struct edges view_edges = {
+		.left = vgeom.x - border.left + 1,
+		.top = vgeom.y - border.top + 1,
+		.right = vgeom.x + vgeom.width + border.right,
+		.bottom = vgeom.y + vgeom.height + border.bottom,
+	};
+	struct edges target_edges = {
+		.left = *x - border.left,
+		.top = *y - border.top,
+		.right = *x + vgeom.width + border.right,
+		.bottom = *y + vgeom.height + border.bottom,
+	};
+
+	if (window_edge_find(RESIST_LEFT, view_edges.left, target_edges.left,
+			target_edges.top, target_edges.bottom, &pos)) {
+		*x = pos + border.left;
+	} else if (window_edge_find(RESIST_RIGHT, view_edges.right,
+			target_edges.right, target_edges.top, target_edges.bottom,
+			&pos)) {
+		*x = pos - vgeom.width - border.right;
+	}
+
+	if (window_edge_find(RESIST_TOP, view_edges.top, target_edges.top,
+			target_edges.left, target_edges.right, &pos)) {
+		*y = pos + border.top;
+	} else if (window_edge_find(RESIST_BOTTOM, view_edges.bottom,
+			target_edges.bottom, target_edges.left, target_edges.right,
+			&pos)) {
+		*y = pos - vgeom.height - border.bottom;
+	}
+}
+
+static void
+window_resize_apply(struct view *view, struct wlr_box *new_view_geo)
+{
+	uint32_t resize_edges = view->server->resize_edges;
+	struct wlr_box vgeom = view->current;
+	struct border border = ssd_get_margin(view->ssd);
+	int pos;
+
+	struct edges view_edges = {
+		.left = vgeom.x - border.left,
+		.top = vgeom.y - border.top,
+		.right = vgeom.x + vgeom.width + border.right,
+		.bottom = vgeom.y + vgeom.height + border.bottom,
+	};
+	/* The position is only final for right/bottom edges, see cursor.c */
+	struct edges target_edges = {
+		.left = view_edges.right - new_view_geo->width
+			- border.left - border.right,
+		.top = view_edges.bottom - new_view_geo->height
+			- border.top - border.bottom,
+		.right = view_edges.left + new_view_geo->width
+			+ border.left + border.right,
+		.bottom = view_edges.top + new_view_geo->height
+			+ border.top + border.bottom,
+	};
+
+	if (resize_edges & WLR_EDGE_LEFT) {
+		if (window_edge_find(RESIST_LEFT, view_edges.left,
+				target_edges.left, view_edges.top,
+				view_edges.bottom, &pos)) {
+			new_view_geo->width = view_edges.right - pos
+				- border.left - border.right;
+		}
+	} else if (resize_edges & WLR_EDGE_RIGHT) {
+		if (window_edge_find(RESIST_RIGHT, view_edges.right,
+				target_edges.right, view_edges.top,
+				view_edges.bottom, &pos)) {
+			new_view_geo->width = pos - view_edges.left
+				- border.left - border.right;
+		}
+	}
+
+	if (resize_edges & WLR_EDGE_TOP) {
+		if (window_edge_find(RESIST_TOP, view_edges.top,
+				target_edges.top, view_edges.left,
+				view_edges.right, &pos)) {
+			new_view_geo->height = view_edges.bottom - pos
+				- border.top - border.bottom;
+		}
+	} else if (resize_edges & WLR_EDGE_BOTTOM) {
+		if (window_edge_find(RESIST_BOTTOM, view_edges.bottom,
+				target_edges.bottom, view_edges.left,
+				view_edges.right, &pos)) {
+			new_view_geo->height = pos - view_edges.top
+				- border.top - border.bottom;
+		}
+	}
+}
+
+void
+resistance_move_apply(struct view *view, double *x, double *y)
+{
+	screen_move_apply(view, x, y);
+	if (rc.window_edge_strength) {
+		window_move_apply(view, x, y);
+	}
+}
+
+void
+resistance_resize_apply(struct view *view, struct wlr_box *new_view_geo)
+{
+	screen_resize_apply(view, new_view_geo);
+	if (rc.window_edge_strength) {
+		window_resize_apply(view, new_view_geo);
+	}
+}
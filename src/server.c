@@ -1,8 +1,11 @@
 // SPDX-License-Identifier: GPL-2.0-only
 #define _POSIX_C_SOURCE 200809L
 #include "config.h"
+#include <inttypes.h>
 #include <signal.h>
+#include <string.h>
 #include <sys/wait.h>
+#include <time.h>
 #include <wlr/backend/headless.h>
 #include <wlr/backend/multi.h>
 #include <wlr/types/wlr_data_control_v1.h>
@@ -19,6 +22,7 @@
 #include <wlr/xwayland.h>
 #endif
 #include "drm-lease-v1-protocol.h"
+#include "common/spawn.h"
 #include "config/rcxml.h"
 #include "config/session.h"
 #include "decorations.h"
@@ -28,8 +32,11 @@
 #include "menu/menu.h"
 #include "regions.h"
 #include "resize_indicator.h"
+#include "snap.h"
 #include "theme.h"
+#include "trace.h"
 #include "view.h"
+#include "window-rules.h"
 #include "workspaces.h"
 #include "xwayland.h"
 
@@ -40,28 +47,102 @@ static struct wlr_compositor *compositor;
 static struct wl_event_source *sighup_source;
 static struct wl_event_source *sigint_source;
 static struct wl_event_source *sigterm_source;
+static struct wl_event_source *sigchld_source;
+#if HAVE_TRACE
+static struct wl_event_source *sigusr1_source;
+#endif
 
 static struct server *g_server;
 
+static double
+msec_since(struct timespec *start)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	double elapsed = (now.tv_sec - start->tv_sec) * 1000.0
+		+ (now.tv_nsec - start->tv_nsec) / 1000000.0;
+	*start = now;
+	return elapsed;
+}
+
+static bool
+section_changed(const uint64_t *old_digest, enum rc_section section)
+{
+	return old_digest[section] != rc.section_digest[section];
+}
+
+/*
+ * rc.xml is always re-parsed and the theme always re-read, which is cheap
+ * thanks to the theme asset cache. The expensive subsystems (decorations,
+ * menus, input devices, regions) are only re-applied when the rc.xml
+ * section, theme or file they depend on actually changed.
+ */
 static void
 reload_config_and_theme(void)
 {
+	TRACE_SCOPE("reload_config_and_theme");
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	struct theme_cache_stats before, after;
+	theme_cache_get_stats(&before);
+
+	uint64_t old_digest[RC_SECTION_COUNT];
+	memcpy(old_digest, rc.section_digest, sizeof(old_digest));
+
 	rcxml_finish();
 	rcxml_read(NULL);
+	if (section_changed(old_digest, RC_SECTION_WINDOW_RULES)) {
+		window_rules_invalidate(NULL);
+	}
+	double config_ms = msec_since(&t);
+
 	theme_finish(g_server->theme);
-	theme_init(g_server->theme, rc.theme_name);
+	bool theme_changed = theme_init(g_server->theme, rc.theme_name);
+	/* Fonts are part of the theme section */
+	theme_changed |= section_changed(old_digest, RC_SECTION_THEME);
+	double theme_ms = msec_since(&t);
+
+	if (theme_changed) {
+		struct view *view;
+		wl_list_for_each(view, &g_server->views, link) {
+			view_reload_ssd(view);
+		}
+	}
+	/* Also applies <resize><popupShow>, which is not tracked */
+	resize_indicator_reconfigure(g_server);
+	double ssd_ms = msec_since(&t);
 
-	struct view *view;
-	wl_list_for_each(view, &g_server->views, link) {
-		view_reload_ssd(view);
+	bool menu_changed = theme_changed || menu_file_changed();
+	if (menu_changed) {
+		menu_reconfigure(g_server);
 	}
+	double menu_ms = msec_since(&t);
 
-	menu_reconfigure(g_server);
-	seat_reconfigure(g_server);
-	regions_reconfigure(g_server);
-	resize_indicator_reconfigure(g_server);
+	bool input_changed = section_changed(old_digest, RC_SECTION_KEYBOARD)
+		|| section_changed(old_digest, RC_SECTION_LIBINPUT);
+	if (input_changed) {
+		seat_reconfigure(g_server);
+	}
+	bool regions_changed = section_changed(old_digest, RC_SECTION_REGIONS);
+	if (regions_changed) {
+		regions_reconfigure(g_server);
+	}
 	kde_server_decoration_update_default();
+	/* The keybinds have been re-created and need their keycodes */
 	keybind_update_keycodes(g_server);
+	double other_ms = msec_since(&t);
+
+	theme_cache_get_stats(&after);
+	wlr_log(WLR_INFO, "reconfigure: config %.2f ms, theme %.2f ms "
+		"(%" PRIu64 " assets reused, %" PRIu64 " rendered), "
+		"decorations %.2f ms%s, menu %.2f ms%s, other %.2f ms "
+		"(input %s, regions %s)",
+		config_ms, theme_ms, after.hits - before.hits,
+		after.misses - before.misses,
+		ssd_ms, theme_changed ? "" : " (unchanged)",
+		menu_ms, menu_changed ? "" : " (unchanged)", other_ms,
+		input_changed ? "reconfigured" : "unchanged",
+		regions_changed ? "reconfigured" : "unchanged");
 }
 
 static int
@@ -72,6 +153,22 @@ handle_sighup(int signal, void *data)
 	return 0;
 }
 
+static int
+handle_sigchld(int signal, void *data)
+{
+	spawn_reap_children();
+	return 0;
+}
+
+#if HAVE_TRACE
+static int
+handle_sigusr1(int signal, void *data)
+{
+	trace_dump();
+	return 0;
+}
+#endif
+
 static int
 handle_sigterm(int signal, void *data)
 {
@@ -232,6 +329,12 @@ server_init(struct server *server)
 		event_loop, SIGINT, handle_sigterm, server->wl_display);
 	sigterm_source = wl_event_loop_add_signal(
 		event_loop, SIGTERM, handle_sigterm, server->wl_display);
+	sigchld_source = wl_event_loop_add_signal(
+		event_loop, SIGCHLD, handle_sigchld, NULL);
+#if HAVE_TRACE
+	sigusr1_source = wl_event_loop_add_signal(
+		event_loop, SIGUSR1, handle_sigusr1, NULL);
+#endif
 	server->wl_event_loop = event_loop;
 
 	/*
@@ -301,7 +404,12 @@ server_init(struct server *server)
 	}
 
 	wl_list_init(&server->views);
+	wl_list_init(&server->views_always_on_top);
+	wl_list_init(&server->views_omnipresent);
 	wl_list_init(&server->unmanaged_surfaces);
+#if HAVE_XWAYLAND
+	wl_list_init(&server->strut_views);
+#endif
 
 	server->ssd_hover_state = ssd_hover_state_new();
 
@@ -493,6 +601,17 @@ server_finish(struct server *server)
 	if (sighup_source) {
 		wl_event_source_remove(sighup_source);
 	}
+	if (sigchld_source) {
+		wl_event_source_remove(sigchld_source);
+		sigchld_source = NULL;
+	}
+	spawn_finish();
+#if HAVE_TRACE
+	if (sigusr1_source) {
+		wl_event_source_remove(sigusr1_source);
+		sigusr1_source = NULL;
+	}
+#endif
 	wl_display_destroy_clients(server->wl_display);
 
 	seat_finish(server);
@@ -502,4 +621,5 @@ server_finish(struct server *server)
 
 	/* TODO: clean up various scene_tree nodes */
 	workspaces_destroy(server);
+	snap_finish();
 }
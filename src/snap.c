@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: GPL-2.0-only
+#include <string.h>
 #include <strings.h>
 #include <wlr/util/box.h>
+#include <wlr/util/log.h>
 #include "labwc.h"
 #include "snap.h"
 #include "view.h"
@@ -60,18 +62,153 @@ snap_get_max_distance(struct view *view)
 	return distance;
 }
 
-struct snap_search {
-	const int search_dir; /* -1: left/up, 1: right/down */
+/*
+ * Outer edges (including SSD margins) of all views, one array per side,
+ * each sorted by position. This lets the edge search below start at the
+ * right position and stop at the first eligible view instead of looking
+ * at every view on the workspace.
+ *
+ * The index is keyed by position only. Whether a view is eligible
+ * (workspace, output, minimized, maximized) is checked while walking it,
+ * because these states change without the edges changing and always-on-top
+ * views are part of every workspace.
+ */
+enum snap_side {
+	SNAP_SIDE_LEFT = 0,
+	SNAP_SIDE_TOP,
+	SNAP_SIDE_RIGHT,
+	SNAP_SIDE_BOTTOM,
+	SNAP_SIDE_COUNT
+};
+
+struct snap_edge {
+	int pos;
+	struct view *view;
+};
+
+static struct wl_array snap_edges[SNAP_SIDE_COUNT];
+
+static int
+border_side(const struct border *border, enum snap_side side)
+{
+	switch (side) {
+	case SNAP_SIDE_LEFT:   return border->left;
+	case SNAP_SIDE_TOP:    return border->top;
+	case SNAP_SIDE_RIGHT:  return border->right;
+	case SNAP_SIDE_BOTTOM: return border->bottom;
+	default: return 0;
+	}
+}
+
+static size_t
+edges_len(enum snap_side side)
+{
+	return snap_edges[side].size / sizeof(struct snap_edge);
+}
+
+/* Index of the first edge with a position not less than pos */
+static size_t
+edges_lower_bound(enum snap_side side, int pos)
+{
+	struct snap_edge *edges = snap_edges[side].data;
+	size_t lo = 0, hi = edges_len(side);
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (edges[mid].pos < pos) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+static void
+edges_remove(enum snap_side side, struct view *view, int pos)
+{
+	struct snap_edge *edges = snap_edges[side].data;
+	size_t len = edges_len(side);
+	for (size_t i = edges_lower_bound(side, pos); i < len
+			&& edges[i].pos == pos; i++) {
+		if (edges[i].view == view) {
+			memmove(&edges[i], &edges[i + 1],
+				(len - i - 1) * sizeof(*edges));
+			snap_edges[side].size -= sizeof(*edges);
+			return;
+		}
+	}
+	wlr_log(WLR_ERROR, "view missing from snap edge index");
+}
+
+static void
+edges_insert(enum snap_side side, struct view *view, int pos)
+{
+	size_t i = edges_lower_bound(side, pos);
+	size_t len = edges_len(side);
+	if (!wl_array_add(&snap_edges[side], sizeof(struct snap_edge))) {
+		wlr_log(WLR_ERROR, "wl_array_add(): out of memory");
+		return;
+	}
+	struct snap_edge *edges = snap_edges[side].data;
+	memmove(&edges[i + 1], &edges[i], (len - i) * sizeof(*edges));
+	edges[i] = (struct snap_edge){ .pos = pos, .view = view };
+}
+
+void
+snap_update_view(struct view *view)
+{
+	struct border edge = snap_get_view_edge(view);
+	if (view->snap_indexed && !memcmp(&edge, &view->snap_edge, sizeof(edge))) {
+		return;
+	}
+	for (enum snap_side side = 0; side < SNAP_SIDE_COUNT; side++) {
+		if (view->snap_indexed) {
+			edges_remove(side, view, border_side(&view->snap_edge, side));
+		}
+		edges_insert(side, view, border_side(&edge, side));
+	}
+	view->snap_edge = edge;
+	view->snap_indexed = true;
+}
+
+void
+snap_remove_view(struct view *view)
+{
+	if (!view->snap_indexed) {
+		return;
+	}
+	for (enum snap_side side = 0; side < SNAP_SIDE_COUNT; side++) {
+		edges_remove(side, view, border_side(&view->snap_edge, side));
+	}
+	view->snap_indexed = false;
+}
 
-	const int add_view_x;
-	const int add_view_y;
-	const int add_view_width;
-	const int add_view_height;
+void
+snap_finish(void)
+{
+	for (enum snap_side side = 0; side < SNAP_SIDE_COUNT; side++) {
+		wl_array_release(&snap_edges[side]);
+		wl_array_init(&snap_edges[side]);
+	}
+}
+
+/*
+ * Bring all views up to date. Only used as a fallback if an edge was
+ * found to be stale, which means a geometry change was not reported
+ * through snap_update_view().
+ */
+static void
+snap_update_all(struct server *server)
+{
+	struct view *view;
+	wl_list_for_each(view, &server->views, link) {
+		snap_update_view(view);
+	}
+}
 
-	const int add_margin_left;
-	const int add_margin_top;
-	const int add_margin_right;
-	const int add_margin_bottom;
+struct snap_search {
+	const int search_dir; /* -1: left/up, 1: right/down */
+	const enum snap_side side;
 };
 
 /* near/far is the left, right, top or bottom border of a window,
@@ -81,48 +218,72 @@ struct snap_search {
  *  - near_left:  search to the left,  snap to right (near) border of a window.
  *  - far_left:   search to the left,  snap to left  (far)  border of a window.
  *
- * structs below define what coordinates and margins to take into
- * account depending near/far, and direction.
+ * structs below define which edges to look at depending on near/far and
+ * direction.
  */
-static const struct snap_search near_left  = { -1,   1, 0, 1, 0,    0,  0,  1,  0 };
-static const struct snap_search near_up    = { -1,   0, 1, 0, 1,    0,  0,  0,  1 };
-static const struct snap_search near_right = {  1,   1, 0, 0, 0,   -1,  0,  0,  0 };
-static const struct snap_search near_down  = {  1,   0, 1, 0, 0,    0, -1,  0,  0 };
-static const struct snap_search far_left   = { -1,   1, 0, 0, 0,   -1,  0,  0,  0 };
-static const struct snap_search far_up     = { -1,   0, 1, 0, 0,    0, -1,  0,  0 };
-static const struct snap_search far_right  = {  1,   1, 0, 1, 0,    0,  0,  1,  0 };
-static const struct snap_search far_down   = {  1,   0, 1, 0, 1,    0,  0,  1,  0 };
+static const struct snap_search near_left  = { -1, SNAP_SIDE_RIGHT };
+static const struct snap_search near_up    = { -1, SNAP_SIDE_BOTTOM };
+static const struct snap_search near_right = {  1, SNAP_SIDE_LEFT };
+static const struct snap_search near_down  = {  1, SNAP_SIDE_TOP };
+static const struct snap_search far_left   = { -1, SNAP_SIDE_LEFT };
+static const struct snap_search far_up     = { -1, SNAP_SIDE_TOP };
+static const struct snap_search far_right  = {  1, SNAP_SIDE_RIGHT };
+static const struct snap_search far_down   = {  1, SNAP_SIDE_BOTTOM };
 
-static inline int
-_snap_next_edge(struct view *view, int start_pos, const struct snap_search def, int max, int gap)
+static bool
+snap_target_eligible(struct view *view, struct view *v)
 {
-	struct output *output = view->output;
-	struct server *server = output->server;
-	struct view *v;
-	int p = max;
-	for_each_view(v, &server->views, LAB_VIEW_CRITERIA_CURRENT_WORKSPACE) {
-		if (v == view || v->output != output || v->minimized
-				|| v->maximized == VIEW_AXIS_BOTH) {
-			continue;
+	return v != view && v->output == view->output && !v->minimized
+		&& v->maximized != VIEW_AXIS_BOTH
+		&& view_matches_criteria(v, LAB_VIEW_CRITERIA_CURRENT_WORKSPACE);
+}
+
+/* Nearest eligible edge in search direction, or NULL if there is none */
+static struct snap_edge *
+snap_find_edge(struct view *view, int start_pos, const struct snap_search def, int gap)
+{
+	struct snap_edge *edges = snap_edges[def.side].data;
+	if (def.search_dir > 0) {
+		/* First edge with pos + gap - start_pos > 0 */
+		size_t len = edges_len(def.side);
+		for (size_t i = edges_lower_bound(def.side, start_pos - gap + 1);
+				i < len; i++) {
+			if (snap_target_eligible(view, edges[i].view)) {
+				return &edges[i];
+			}
+		}
+	} else {
+		/* Last edge with pos + gap - start_pos < 0 */
+		for (size_t i = edges_lower_bound(def.side, start_pos - gap); i-- > 0;) {
+			if (snap_target_eligible(view, edges[i].view)) {
+				return &edges[i];
+			}
 		}
+	}
+	return NULL;
+}
 
-		struct border margin = ssd_get_margin(v->ssd);
-		int vp = -start_pos;
-		vp += def.add_margin_left   * margin.left;
-		vp += def.add_margin_top    * margin.top;
-		vp += def.add_margin_right  * margin.right;
-		vp += def.add_margin_bottom * margin.bottom;
-		vp += def.add_view_x        * v->pending.x;
-		vp += def.add_view_y        * v->pending.y;
-		vp += def.add_view_width    * v->pending.width;
-		vp += def.add_view_height   * v->pending.height;
-		vp += gap;
+static bool
+snap_edge_is_stale(struct snap_edge *edge, enum snap_side side)
+{
+	struct border current = snap_get_view_edge(edge->view);
+	return border_side(&current, side) != edge->pos;
+}
 
-		if (def.search_dir * vp > 0 && def.search_dir * (vp - p) < 0) {
-			p = vp;
-		}
+static inline int
+_snap_next_edge(struct view *view, int start_pos, const struct snap_search def, int max, int gap)
+{
+	struct snap_edge *edge = snap_find_edge(view, start_pos, def, gap);
+	if (edge && snap_edge_is_stale(edge, def.side)) {
+		wlr_log(WLR_DEBUG, "stale snap edge index, rebuilding");
+		snap_update_all(view->output->server);
+		edge = snap_find_edge(view, start_pos, def, gap);
+	}
+	if (!edge) {
+		return max;
 	}
-	return p;
+	int vp = edge->pos + gap - start_pos;
+	return def.search_dir * (vp - max) < 0 ? vp : max;
 }
 
 static void
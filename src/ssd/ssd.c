@@ -12,6 +12,7 @@
 #include "labwc.h"
 #include "ssd-internal.h"
 #include "theme.h"
+#include "trace.h"
 #include "view.h"
 
 struct border
@@ -137,12 +138,12 @@ ssd_get_part_type(const struct ssd *ssd, struct wlr_scene_node *node)
 }
 
 enum ssd_part_type
-ssd_at(const struct ssd *ssd, struct wlr_scene *scene, double lx, double ly)
+ssd_at(const struct ssd *ssd, struct server *server, double lx, double ly)
 {
-	assert(scene);
+	assert(server);
 	double sx, sy;
-	struct wlr_scene_node *node = wlr_scene_node_at(
-		&scene->tree.node, lx, ly, &sx, &sy);
+	struct wlr_scene_node *node =
+		desktop_node_at(server, lx, ly, &sx, &sy);
 	return ssd_get_part_type(ssd, node);
 }
 
@@ -181,6 +182,8 @@ ssd_create(struct view *view, bool active)
 	ssd->tree = wlr_scene_tree_create(view->scene_tree);
 	wlr_scene_node_lower_to_bottom(&ssd->tree->node);
 	ssd->titlebar.height = view->server->theme->title_height;
+	/* Only the title of the visible state gets rendered right away */
+	ssd->state.active = active;
 	ssd_extents_create(ssd);
 	ssd_border_create(ssd);
 	ssd_titlebar_create(ssd);
@@ -214,6 +217,7 @@ ssd_update_margin(struct ssd *ssd)
 void
 ssd_update_geometry(struct ssd *ssd)
 {
+	TRACE_SCOPE("ssd_update_geometry");
 	if (!ssd) {
 		return;
 	}
@@ -331,6 +335,15 @@ ssd_set_active(struct ssd *ssd, bool active)
 	wlr_scene_node_set_enabled(&ssd->titlebar.active.tree->node, active);
 	wlr_scene_node_set_enabled(&ssd->border.inactive.tree->node, !active);
 	wlr_scene_node_set_enabled(&ssd->titlebar.inactive.tree->node, !active);
+
+	if (ssd->state.active != active) {
+		ssd->state.active = active;
+		/* Render the title of the now visible state if outdated */
+		struct ssd_state_title *title = &ssd->state.title;
+		if (active ? title->active.stale : title->inactive.stale) {
+			ssd_update_title(ssd);
+		}
+	}
 }
 
 void
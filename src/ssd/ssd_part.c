@@ -1,11 +1,22 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
 #include <assert.h>
+#include <stdlib.h>
+#include "buffer.h"
 #include "common/list.h"
 #include "common/mem.h"
+#include "common/scaled_scene_buffer.h"
 #include "labwc.h"
 #include "node.h"
 #include "ssd-internal.h"
+#include "theme.h"
+
+/* A theme buffer shown at a given logical size */
+struct theme_buffer_source {
+	struct lab_data_buffer *buffer;
+	int width;
+	int height;
+};
 
 /* Internal helpers */
 static void
@@ -67,14 +78,50 @@ add_scene_rect(struct wl_list *list, enum ssd_part_type type,
 	return part;
 }
 
+static struct lab_data_buffer *
+theme_buffer_create(struct scaled_scene_buffer *scaled_buffer, double scale)
+{
+	struct theme_buffer_source *source = scaled_buffer->data;
+	return theme_buffer_at_scale(source->buffer, source->width,
+		source->height, scale);
+}
+
+static void
+theme_buffer_destroy(struct scaled_scene_buffer *scaled_buffer)
+{
+	free(scaled_buffer->data);
+	scaled_buffer->data = NULL;
+}
+
+static const struct scaled_scene_buffer_impl theme_buffer_impl = {
+	.create_buffer = theme_buffer_create,
+	.destroy = theme_buffer_destroy,
+};
+
+/*
+ * The theme renders each button and corner once per output scale and
+ * shares the result between all views, so the buffers are not dropped
+ * along with the scene node.
+ */
 struct ssd_part *
 add_scene_buffer(struct wl_list *list, enum ssd_part_type type,
 	struct wlr_scene_tree *parent, struct wlr_buffer *buffer,
-	int x, int y)
+	struct wlr_box geo)
 {
 	struct ssd_part *part = add_scene_part(list, type);
-	part->node = &wlr_scene_buffer_create(parent, buffer)->node;
-	wlr_scene_node_set_position(part->node, x, y);
+	struct theme_buffer_source *source = znew(*source);
+	source->buffer = wl_container_of(buffer, source->buffer, base);
+	source->width = geo.width;
+	source->height = geo.height;
+
+	struct scaled_scene_buffer *scaled_buffer = scaled_scene_buffer_create(
+		parent, &theme_buffer_impl, /* drop_buffer */ false);
+	scaled_buffer->data = source;
+	/* Initial buffer for scale 1, replaced on entering outputs */
+	scaled_scene_buffer_invalidate_cache(scaled_buffer);
+
+	part->node = &scaled_buffer->scene_buffer->node;
+	wlr_scene_node_set_position(part->node, geo.x, geo.y);
 	return part;
 }
 
@@ -104,8 +151,14 @@ add_scene_button_corner(struct wl_list *part_list, enum ssd_part_type type,
 	 * Background, x and y adjusted for border_width which is
 	 * already included in rendered theme.c / corner_buffer
 	 */
+	struct wlr_box corner_geo = {
+		.x = -offset_x,
+		.y = -rc.theme->border_width,
+		.width = corner_buffer->width,
+		.height = corner_buffer->height,
+	};
 	add_scene_buffer(part_list, corner_type, parent, corner_buffer,
-		-offset_x, -rc.theme->border_width);
+		corner_geo);
 
 	/* Finally just put a usual theme button on top, using an invisible hitbox */
 	add_scene_button(part_list, type, parent, invisible, icon_buffer, hover_buffer, 0, view);
@@ -158,12 +211,7 @@ add_scene_button(struct wl_list *part_list, enum ssd_part_type type,
 	struct wlr_box icon_geo = get_scale_box(icon_buffer,
 		SSD_BUTTON_WIDTH, rc.theme->title_height);
 	struct ssd_part *icon_part = add_scene_buffer(part_list, type,
-		icon_tree, icon_buffer, icon_geo.x, icon_geo.y);
-
-	/* Make sure big icons are scaled down if necessary */
-	wlr_scene_buffer_set_dest_size(
-		wlr_scene_buffer_from_node(icon_part->node),
-		icon_geo.width, icon_geo.height);
+		icon_tree, icon_buffer, icon_geo);
 
 	/* Hover icon */
 	struct wlr_scene_tree *hover_tree = wlr_scene_tree_create(parent);
@@ -171,12 +219,7 @@ add_scene_button(struct wl_list *part_list, enum ssd_part_type type,
 	struct wlr_box hover_geo = get_scale_box(hover_buffer,
 		SSD_BUTTON_WIDTH, rc.theme->title_height);
 	struct ssd_part *hover_part = add_scene_buffer(part_list, type,
-		hover_tree, hover_buffer, hover_geo.x, hover_geo.y);
-
-	/* Make sure big icons are scaled down if necessary */
-	wlr_scene_buffer_set_dest_size(
-		wlr_scene_buffer_from_node(hover_part->node),
-		hover_geo.width, hover_geo.height);
+		hover_tree, hover_buffer, hover_geo);
 
 	struct ssd_button *button = ssd_button_descriptor_create(button_root->node);
 	button->type = type;
@@ -203,22 +246,14 @@ add_toggled_icon(struct wl_list *part_list, enum ssd_part_type type,
 		SSD_BUTTON_WIDTH, rc.theme->title_height);
 
 	struct ssd_part *alticon_part = add_scene_buffer(part_list, type,
-		button->icon_tree, icon_buffer, icon_geo.x, icon_geo.y);
-
-	wlr_scene_buffer_set_dest_size(
-		wlr_scene_buffer_from_node(alticon_part->node),
-		icon_geo.width, icon_geo.height);
+		button->icon_tree, icon_buffer, icon_geo);
 
 	wlr_scene_node_set_enabled(alticon_part->node, false);
 
 	struct wlr_box hover_geo = get_scale_box(hover_buffer,
 		SSD_BUTTON_WIDTH, rc.theme->title_height);
 	struct ssd_part *althover_part = add_scene_buffer(part_list, type,
-		button->hover_tree, hover_buffer, hover_geo.x, hover_geo.y);
-
-	wlr_scene_buffer_set_dest_size(
-		wlr_scene_buffer_from_node(althover_part->node),
-		hover_geo.width, hover_geo.height);
+		button->hover_tree, hover_buffer, hover_geo);
 
 	wlr_scene_node_set_enabled(althover_part->node, false);
 
@@ -11,6 +11,7 @@
 #include "node.h"
 #include "ssd-internal.h"
 #include "theme.h"
+#include "trace.h"
 #include "view.h"
 
 #define FOR_EACH_STATE(ssd, tmp) FOR_EACH(tmp, \
@@ -258,6 +259,11 @@ ssd_titlebar_destroy(struct ssd *ssd)
  * of the title (font family/size) or background of
  * the title (different button/border width).
  *
+ * The title of the hidden state is not rendered though. It is marked as
+ * stale instead and updated by ssd_set_active() once it becomes visible.
+ * Repeated focus changes thus re-use the buffers of both states as long as
+ * the title and width stay the same.
+ *
  * Both, wlr_scene_node_set_enabled() and wlr_scene_node_set_position()
  * check for actual changes and return early if there is no change in state.
  * Always using wlr_scene_node_set_enabled(node, true) will thus not cause
@@ -319,6 +325,7 @@ ssd_update_title_positions(struct ssd *ssd)
 void
 ssd_update_title(struct ssd *ssd)
 {
+	TRACE_SCOPE("ssd_update_title");
 	if (!ssd) {
 		return;
 	}
@@ -342,14 +349,17 @@ ssd_update_title(struct ssd *ssd)
 		- SSD_BUTTON_WIDTH * SSD_BUTTON_COUNT;
 
 	FOR_EACH_STATE(ssd, subtree) {
+		bool visible;
 		if (subtree == &ssd->titlebar.active) {
 			dstate = &state->active;
 			text_color = theme->window_active_label_text_color;
 			font = &rc.font_activewindow;
+			visible = ssd->state.active;
 		} else {
 			dstate = &state->inactive;
 			text_color = theme->window_inactive_label_text_color;
 			font = &rc.font_inactivewindow;
+			visible = !ssd->state.active;
 		}
 
 		if (title_bg_width <= 0) {
@@ -357,12 +367,18 @@ ssd_update_title(struct ssd *ssd)
 			continue;
 		}
 
-		if (title_unchanged
+		if (title_unchanged && !dstate->stale
 				&& !dstate->truncated && dstate->width < title_bg_width) {
 			/* title the same + we don't need to resize title */
 			continue;
 		}
 
+		if (!visible) {
+			/* Defer rendering until the state is shown */
+			dstate->stale = true;
+			continue;
+		}
+
 		part = ssd_get_part(&subtree->parts, LAB_SSD_PART_TITLE);
 		if (!part) {
 			/* Initialize part and wlr_scene_buffer without attaching a buffer */
@@ -384,6 +400,7 @@ ssd_update_title(struct ssd *ssd)
 		/* And finally update the cache */
 		dstate->width = part->buffer ? part->buffer->width : 0;
 		dstate->truncated = title_bg_width <= dstate->width;
+		dstate->stale = false;
 
 	} FOR_EACH_END
 
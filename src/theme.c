@@ -15,6 +15,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <wlr/util/box.h>
 #include <wlr/util/log.h>
 #include <strings.h>
@@ -23,9 +24,11 @@
 #include "common/font.h"
 #include "common/graphic-helpers.h"
 #include "common/match.h"
+#include "common/mem.h"
 #include "common/string-helpers.h"
 #include "config/rcxml.h"
 #include "button/button-png.h"
+#include "button/common.h"
 
 #if HAVE_RSVG
 #include "button/button-svg.h"
@@ -46,21 +49,225 @@ struct button {
 	} active, inactive;
 };
 
-static void
-drop(struct lab_data_buffer **buffer)
+/*
+ * Decoded button images, hover fallbacks and corners are kept across
+ * theme_finish()/theme_init() cycles. A reconfigure then only decodes
+ * files which changed on disk and re-renders assets whose parameters
+ * (colours, sizes) changed. Assets not used by the most recent
+ * theme_init() are evicted at its end.
+ *
+ * The cache owns the buffers; struct theme only borrows them.
+ */
+enum theme_asset_type {
+	THEME_ASSET_PNG,
+	THEME_ASSET_SVG,
+	THEME_ASSET_XBM,
+	THEME_ASSET_BITMAP,
+	THEME_ASSET_HOVER,
+	THEME_ASSET_CORNER,
+};
+
+struct theme_asset {
+	/* Key; fields not applicable to the type are left zeroed */
+	enum theme_asset_type type;
+	char *path;
+	struct timespec mtime;
+	off_t file_size;
+	int width;
+	int height;
+	float color[4];
+	float border_color[4];
+	double radius;
+	double line_width;
+	int corner;
+	char bitmap[6];
+	const struct lab_data_buffer *source;
+
+	struct lab_data_buffer *buffer; /* NULL if decoding failed */
+	char *name; /* relative filename, to re-render svg files */
+	struct wl_array scaled; /* struct scaled_asset */
+	uint32_t generation;
+	struct wl_list link; /* theme_cache.assets */
+};
+
+/* An asset rendered for an output scale, see theme_buffer_at_scale() */
+struct scaled_asset {
+	int width;
+	int height;
+	double scale;
+	struct lab_data_buffer *buffer;
+};
+
+static struct {
+	struct wl_list assets;
+	uint32_t generation;
+	struct theme_cache_stats stats;
+} theme_cache;
+
+static bool
+asset_key_equal(const struct theme_asset *a, const struct theme_asset *b)
 {
-	if (*buffer) {
-		wlr_buffer_drop(&(*buffer)->base);
-		*buffer = NULL;
+	if (!a->path != !b->path || (a->path && strcmp(a->path, b->path))) {
+		return false;
+	}
+	return a->type == b->type
+		&& a->mtime.tv_sec == b->mtime.tv_sec
+		&& a->mtime.tv_nsec == b->mtime.tv_nsec
+		&& a->file_size == b->file_size
+		&& a->width == b->width
+		&& a->height == b->height
+		&& !memcmp(a->color, b->color, sizeof(a->color))
+		&& !memcmp(a->border_color, b->border_color,
+			sizeof(a->border_color))
+		&& a->radius == b->radius
+		&& a->line_width == b->line_width
+		&& a->corner == b->corner
+		&& !memcmp(a->bitmap, b->bitmap, sizeof(a->bitmap))
+		&& a->source == b->source;
+}
+
+static struct theme_asset *
+asset_find(const struct theme_asset *key)
+{
+	struct theme_asset *asset;
+	wl_list_for_each(asset, &theme_cache.assets, link) {
+		if (asset_key_equal(asset, key)) {
+			asset->generation = theme_cache.generation;
+			theme_cache.stats.hits++;
+			return asset;
+		}
 	}
+	theme_cache.stats.misses++;
+	return NULL;
 }
 
+static struct lab_data_buffer *
+asset_add(const struct theme_asset *key, struct lab_data_buffer *buffer)
+{
+	struct theme_asset *asset = znew(*asset);
+	*asset = *key;
+	asset->path = key->path ? xstrdup(key->path) : NULL;
+	asset->name = key->name ? xstrdup(key->name) : NULL;
+	wl_array_init(&asset->scaled);
+	asset->buffer = buffer;
+	asset->generation = theme_cache.generation;
+	wl_list_insert(&theme_cache.assets, &asset->link);
+	return buffer;
+}
+
+static void
+asset_destroy(struct theme_asset *asset)
+{
+	if (asset->buffer) {
+		wlr_buffer_drop(&asset->buffer->base);
+	}
+	struct scaled_asset *scaled;
+	wl_array_for_each(scaled, &asset->scaled) {
+		wlr_buffer_drop(&scaled->buffer->base);
+	}
+	wl_array_release(&asset->scaled);
+	wl_list_remove(&asset->link);
+	free(asset->path);
+	free(asset->name);
+	free(asset);
+}
+
+/* Evict assets which the current theme no longer uses */
 static void
-create_hover_fallback(struct theme *theme, struct lab_data_buffer **hover_buffer,
-		struct lab_data_buffer *icon_buffer)
+assets_sweep(void)
+{
+	struct theme_asset *asset, *tmp;
+	wl_list_for_each_safe(asset, tmp, &theme_cache.assets, link) {
+		if (asset->generation != theme_cache.generation) {
+			asset_destroy(asset);
+			theme_cache.stats.evictions++;
+		}
+	}
+}
+
+/*
+ * Load button image @name from the theme directory, keyed by its path,
+ * modification time and size as well as @rgba (xbm) and @size (svg).
+ */
+static struct lab_data_buffer *
+load_file_asset(enum theme_asset_type type, const char *name, float *rgba,
+		int size)
+{
+	char path[4096] = { 0 };
+	button_filename(name, path, sizeof(path));
+	struct stat st;
+	if (stat(path, &st) < 0 || !S_ISREG(st.st_mode)) {
+		return NULL;
+	}
+
+	struct theme_asset key = {
+		.type = type,
+		.path = path,
+		.name = (char *)name,
+		.mtime = st.st_mtim,
+		.file_size = st.st_size,
+		.width = size,
+		.height = size,
+	};
+	if (rgba) {
+		memcpy(key.color, rgba, sizeof(key.color));
+	}
+	struct theme_asset *asset = asset_find(&key);
+	if (asset) {
+		return asset->buffer;
+	}
+
+	struct lab_data_buffer *buffer = NULL;
+	switch (type) {
+	case THEME_ASSET_PNG:
+		button_png_load(name, &buffer);
+		break;
+#if HAVE_RSVG
+	case THEME_ASSET_SVG:
+		button_svg_load(name, &buffer, size);
+		break;
+#endif
+	case THEME_ASSET_XBM:
+		button_xbm_load(name, &buffer, rgba);
+		break;
+	default:
+		break;
+	}
+	return asset_add(&key, buffer);
+}
+
+static struct lab_data_buffer *
+load_bitmap_asset(const char *bitmap, float *rgba)
+{
+	struct theme_asset key = { .type = THEME_ASSET_BITMAP };
+	memcpy(key.bitmap, bitmap, sizeof(key.bitmap));
+	memcpy(key.color, rgba, sizeof(key.color));
+	struct theme_asset *asset = asset_find(&key);
+	if (asset) {
+		return asset->buffer;
+	}
+
+	struct lab_data_buffer *buffer = NULL;
+	button_xbm_from_bitmap(bitmap, &buffer, rgba);
+	return asset_add(&key, buffer);
+}
+
+static struct lab_data_buffer *
+create_hover_fallback(struct theme *theme, struct lab_data_buffer *icon_buffer)
 {
 	assert(icon_buffer);
-	assert(!*hover_buffer);
+
+	/* icon_buffer is itself cached and therefore alive while we are */
+	struct theme_asset key = {
+		.type = THEME_ASSET_HOVER,
+		.width = SSD_BUTTON_WIDTH,
+		.height = theme->title_height,
+		.source = icon_buffer,
+	};
+	struct theme_asset *asset = asset_find(&key);
+	if (asset) {
+		return asset->buffer;
+	}
 
 	struct surface_context icon =
 		get_cairo_surface_from_lab_data_buffer(icon_buffer);
@@ -89,9 +296,10 @@ create_hover_fallback(struct theme *theme, struct lab_data_buffer **hover_buffer
 		}
 	}
 
-	*hover_buffer = buffer_create_cairo(width, height, 1.0, true);
+	struct lab_data_buffer *hover_buffer =
+		buffer_create_cairo(width, height, 1.0, true);
 
-	cairo_t *cairo = (*hover_buffer)->cairo;
+	cairo_t *cairo = hover_buffer->cairo;
 	cairo_surface_t *surf = cairo_get_target(cairo);
 
 	/* Background */
@@ -108,6 +316,7 @@ create_hover_fallback(struct theme *theme, struct lab_data_buffer **hover_buffer
 	if (icon.is_duplicate) {
 		cairo_surface_destroy(icon.surface);
 	}
+	return asset_add(&key, hover_buffer);
 }
 
 /*
@@ -220,35 +429,38 @@ load_buttons(struct theme *theme)
 	for (size_t i = 0; i < ARRAY_SIZE(buttons); ++i) {
 		struct button *b = &buttons[i];
 
-		drop(b->active.buffer);
-		drop(b->inactive.buffer);
-
 		/* PNG */
 		snprintf(filename, sizeof(filename), "%s-active.png", b->name);
-		button_png_load(filename, b->active.buffer);
+		*b->active.buffer = load_file_asset(THEME_ASSET_PNG, filename,
+			NULL, 0);
 		snprintf(filename, sizeof(filename), "%s-inactive.png", b->name);
-		button_png_load(filename, b->inactive.buffer);
+		*b->inactive.buffer = load_file_asset(THEME_ASSET_PNG, filename,
+			NULL, 0);
 
 #if HAVE_RSVG
 		/* SVG */
 		int size = theme->title_height - 2 * theme->padding_height;
 		if (!*b->active.buffer) {
 			snprintf(filename, sizeof(filename), "%s-active.svg", b->name);
-			button_svg_load(filename, b->active.buffer, size);
+			*b->active.buffer = load_file_asset(THEME_ASSET_SVG,
+				filename, NULL, size);
 		}
 		if (!*b->inactive.buffer) {
 			snprintf(filename, sizeof(filename), "%s-inactive.svg", b->name);
-			button_svg_load(filename, b->inactive.buffer, size);
+			*b->inactive.buffer = load_file_asset(THEME_ASSET_SVG,
+				filename, NULL, size);
 		}
 #endif
 
 		/* XBM */
 		snprintf(filename, sizeof(filename), "%s.xbm", b->name);
 		if (!*b->active.buffer) {
-			button_xbm_load(filename, b->active.buffer, b->active.rgba);
+			*b->active.buffer = load_file_asset(THEME_ASSET_XBM,
+				filename, b->active.rgba, 0);
 		}
 		if (!*b->inactive.buffer) {
-			button_xbm_load(filename, b->inactive.buffer, b->inactive.rgba);
+			*b->inactive.buffer = load_file_asset(THEME_ASSET_XBM,
+				filename, b->inactive.rgba, 0);
 		}
 
 		/*
@@ -261,10 +473,12 @@ load_buttons(struct theme *theme)
 			filename[0] = '\0';
 		}
 		if (!*b->active.buffer) {
-			button_xbm_load(filename, b->active.buffer, b->active.rgba);
+			*b->active.buffer = load_file_asset(THEME_ASSET_XBM,
+				filename, b->active.rgba, 0);
 		}
 		if (!*b->inactive.buffer) {
-			button_xbm_load(filename, b->inactive.buffer, b->inactive.rgba);
+			*b->inactive.buffer = load_file_asset(THEME_ASSET_XBM,
+				filename, b->inactive.rgba, 0);
 		}
 
 		/*
@@ -277,12 +491,12 @@ load_buttons(struct theme *theme)
 			continue;
 		}
 		if (!*b->active.buffer) {
-			button_xbm_from_bitmap(b->fallback_button,
-				b->active.buffer, b->active.rgba);
+			*b->active.buffer = load_bitmap_asset(
+				b->fallback_button, b->active.rgba);
 		}
 		if (!*b->inactive.buffer) {
-			button_xbm_from_bitmap(b->fallback_button,
-				b->inactive.buffer, b->inactive.rgba);
+			*b->inactive.buffer = load_bitmap_asset(
+				b->fallback_button, b->inactive.rgba);
 		}
 	}
 
@@ -305,13 +519,13 @@ load_buttons(struct theme *theme)
 			struct button *base = &buttons[j];
 			if (!strcmp(basename, base->name)) {
 				if (!*hover_button->active.buffer) {
-					create_hover_fallback(theme,
-						hover_button->active.buffer,
+					*hover_button->active.buffer =
+						create_hover_fallback(theme,
 						*base->active.buffer);
 				}
 				if (!*hover_button->inactive.buffer) {
-					create_hover_fallback(theme,
-						hover_button->inactive.buffer,
+					*hover_button->inactive.buffer =
+						create_hover_fallback(theme,
 						*base->inactive.buffer);
 				}
 				break;
@@ -640,6 +854,16 @@ entry(struct theme *theme, const char *key, const char *value)
 	}
 }
 
+static uint64_t
+digest_update(uint64_t digest, const char *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		digest ^= (unsigned char)data[i];
+		digest *= 0x100000001b3;
+	}
+	return digest;
+}
+
 static void
 parse_config_line(char *line, char **key, char **value)
 {
@@ -660,6 +884,11 @@ process_line(struct theme *theme, char *line)
 	}
 	char *key = NULL, *value = NULL;
 	parse_config_line(line, &key, &value);
+	if (!key || !value) {
+		return;
+	}
+	theme->digest = digest_update(theme->digest, key, strlen(key) + 1);
+	theme->digest = digest_update(theme->digest, value, strlen(value) + 1);
 	entry(theme, key, value);
 }
 
@@ -734,7 +963,7 @@ struct rounded_corner_ctx {
 };
 
 static struct lab_data_buffer *
-rounded_rect(struct rounded_corner_ctx *ctx)
+rounded_rect(struct rounded_corner_ctx *ctx, double scale)
 {
 	/* 1 degree in radians (=2π/360) */
 	double deg = 0.017453292519943295;
@@ -747,9 +976,7 @@ rounded_rect(struct rounded_corner_ctx *ctx)
 	double h = ctx->box->height;
 	double r = ctx->radius;
 
-	struct lab_data_buffer *buffer;
-	/* TODO: scale */
-	buffer = buffer_create_cairo(w, h, 1, true);
+	struct lab_data_buffer *buffer = buffer_create_cairo(w, h, scale, true);
 
 	cairo_t *cairo = buffer->cairo;
 	cairo_surface_t *surf = cairo_get_target(cairo);
@@ -898,6 +1125,183 @@ out:
 	return buffer;
 }
 
+static struct lab_data_buffer *
+load_corner_asset(struct rounded_corner_ctx *ctx)
+{
+	struct theme_asset key = {
+		.type = THEME_ASSET_CORNER,
+		.width = ctx->box->width,
+		.height = ctx->box->height,
+		.radius = ctx->radius,
+		.line_width = ctx->line_width,
+		.corner = ctx->corner,
+	};
+	memcpy(key.color, ctx->fill_color, sizeof(key.color));
+	memcpy(key.border_color, ctx->border_color, sizeof(key.border_color));
+	struct theme_asset *asset = asset_find(&key);
+	if (asset) {
+		return asset->buffer;
+	}
+	return asset_add(&key, rounded_rect(ctx, 1.0));
+}
+
+/*
+ * Paint @source into a new buffer of @width x @height logical pixels
+ * rendered for @scale. Only used for raster sources which cannot be
+ * re-rendered at a higher resolution; xbm bitmaps are upscaled with
+ * NEAREST to keep their edges sharp.
+ */
+static struct lab_data_buffer *
+paint_scaled(struct lab_data_buffer *source, int width, int height,
+		double scale, cairo_filter_t filter)
+{
+	struct surface_context src = get_cairo_surface_from_lab_data_buffer(source);
+	if (!src.surface) {
+		return NULL;
+	}
+	int src_width = cairo_image_surface_get_width(src.surface);
+	int src_height = cairo_image_surface_get_height(src.surface);
+
+	struct lab_data_buffer *buffer =
+		buffer_create_cairo(width, height, scale, true);
+	cairo_t *cairo = buffer->cairo;
+	cairo_save(cairo);
+	cairo_scale(cairo, (double)width / src_width,
+		(double)height / src_height);
+	cairo_set_source_surface(cairo, src.surface, 0, 0);
+	cairo_pattern_set_filter(cairo_get_source(cairo), filter);
+	cairo_paint(cairo);
+	cairo_restore(cairo);
+	cairo_surface_flush(cairo_get_target(cairo));
+
+	if (src.is_duplicate) {
+		cairo_surface_destroy(src.surface);
+	}
+	return buffer;
+}
+
+static struct lab_data_buffer *
+render_scaled(struct theme_asset *asset, int width, int height, double scale)
+{
+	switch (asset->type) {
+	case THEME_ASSET_CORNER: {
+		struct wlr_box box = { .width = width, .height = height };
+		struct rounded_corner_ctx ctx = {
+			.box = &box,
+			.radius = asset->radius,
+			.line_width = asset->line_width,
+			.fill_color = asset->color,
+			.border_color = asset->border_color,
+			.corner = asset->corner,
+		};
+		return rounded_rect(&ctx, scale);
+	}
+#if HAVE_RSVG
+	case THEME_ASSET_SVG: {
+		/* Rasterise the svg 1:1 for the target pixel size */
+		struct lab_data_buffer *pixels = NULL;
+		button_svg_load(asset->name, &pixels,
+			MAX(width, height) * scale + 0.5);
+		if (!pixels) {
+			break;
+		}
+		struct lab_data_buffer *buffer = paint_scaled(pixels, width,
+			height, scale, CAIRO_FILTER_GOOD);
+		wlr_buffer_drop(&pixels->base);
+		return buffer;
+	}
+#endif
+	case THEME_ASSET_HOVER: {
+		/* Re-compose from the base icon rendered at the same scale */
+		double ratio = (double)width / asset->buffer->unscaled_width;
+		struct lab_data_buffer *source =
+			(struct lab_data_buffer *)asset->source;
+		int icon_width = source->unscaled_width * ratio;
+		int icon_height = source->unscaled_height * ratio;
+		struct lab_data_buffer *icon = theme_buffer_at_scale(source,
+			icon_width, icon_height, scale);
+		if (!icon) {
+			break;
+		}
+		struct lab_data_buffer *buffer =
+			buffer_create_cairo(width, height, scale, true);
+		cairo_t *cairo = buffer->cairo;
+		struct surface_context src =
+			get_cairo_surface_from_lab_data_buffer(icon);
+		cairo_set_source_surface(cairo, src.surface,
+			(width - icon_width) / 2, (height - icon_height) / 2);
+		cairo_paint(cairo);
+		set_cairo_color(cairo, (float[4]) { 0.5f, 0.5f, 0.5f, 0.3f});
+		cairo_rectangle(cairo, 0, 0, width, height);
+		cairo_fill(cairo);
+		cairo_surface_flush(cairo_get_target(cairo));
+		if (src.is_duplicate) {
+			cairo_surface_destroy(src.surface);
+		}
+		return buffer;
+	}
+	case THEME_ASSET_XBM:
+	case THEME_ASSET_BITMAP:
+		return paint_scaled(asset->buffer, width, height, scale,
+			CAIRO_FILTER_NEAREST);
+	default:
+		break;
+	}
+	return paint_scaled(asset->buffer, width, height, scale,
+		CAIRO_FILTER_GOOD);
+}
+
+struct lab_data_buffer *
+theme_buffer_at_scale(struct lab_data_buffer *buffer, int width, int height,
+		double scale)
+{
+	if (!buffer || width <= 0 || height <= 0) {
+		return NULL;
+	}
+	if (scale == 1.0 && (uint32_t)width == buffer->unscaled_width
+			&& (uint32_t)height == buffer->unscaled_height) {
+		return buffer;
+	}
+
+	struct theme_asset *asset;
+	wl_list_for_each(asset, &theme_cache.assets, link) {
+		if (asset->buffer == buffer) {
+			break;
+		}
+	}
+	if (&asset->link == &theme_cache.assets) {
+		wlr_log(WLR_DEBUG, "not a theme buffer");
+		return NULL;
+	}
+
+	struct scaled_asset *scaled;
+	wl_array_for_each(scaled, &asset->scaled) {
+		if (scaled->width == width && scaled->height == height
+				&& scaled->scale == scale) {
+			return scaled->buffer;
+		}
+	}
+
+	struct lab_data_buffer *scaled_buffer =
+		render_scaled(asset, width, height, scale);
+	if (!scaled_buffer) {
+		return NULL;
+	}
+	theme_cache.stats.scaled++;
+	scaled = wl_array_add(&asset->scaled, sizeof(*scaled));
+	if (!scaled) {
+		wlr_buffer_drop(&scaled_buffer->base);
+		return NULL;
+	}
+	*scaled = (struct scaled_asset){
+		.width = width,
+		.height = height,
+		.scale = scale,
+		.buffer = scaled_buffer,
+	};
+	return scaled_buffer;
+}
+
 static void
 create_corners(struct theme *theme)
 {
@@ -916,20 +1320,20 @@ create_corners(struct theme *theme)
 		.border_color = theme->window_active_border_color,
 		.corner = LAB_CORNER_TOP_LEFT,
 	};
-	theme->corner_top_left_active_normal = rounded_rect(&ctx);
+	theme->corner_top_left_active_normal = load_corner_asset(&ctx);
 
 	ctx.fill_color = theme->window_inactive_title_bg_color,
 	ctx.border_color = theme->window_inactive_border_color,
-	theme->corner_top_left_inactive_normal = rounded_rect(&ctx);
+	theme->corner_top_left_inactive_normal = load_corner_asset(&ctx);
 
 	ctx.corner = LAB_CORNER_TOP_RIGHT;
 	ctx.fill_color = theme->window_active_title_bg_color,
 	ctx.border_color = theme->window_active_border_color,
-	theme->corner_top_right_active_normal = rounded_rect(&ctx);
+	theme->corner_top_right_active_normal = load_corner_asset(&ctx);
 
 	ctx.fill_color = theme->window_inactive_title_bg_color,
 	ctx.border_color = theme->window_inactive_border_color,
-	theme->corner_top_right_inactive_normal = rounded_rect(&ctx);
+	theme->corner_top_right_inactive_normal = load_corner_asset(&ctx);
 }
 
 static void
@@ -991,9 +1395,17 @@ post_processing(struct theme *theme)
 	}
 }
 
-void
+bool
 theme_init(struct theme *theme, const char *theme_name)
 {
+	if (!theme_cache.assets.next) {
+		wl_list_init(&theme_cache.assets);
+	}
+	theme_cache.generation++;
+	uint64_t old_digest = theme->digest;
+	uint64_t old_misses = theme_cache.stats.misses;
+	theme->digest = 0xcbf29ce484222325;
+
 	/*
 	 * Set some default values. This is particularly important on
 	 * reconfigure as not all themes set all options
@@ -1009,17 +1421,43 @@ theme_init(struct theme *theme, const char *theme_name)
 	post_processing(theme);
 	create_corners(theme);
 	load_buttons(theme);
+	assets_sweep();
+
+	/*
+	 * Everything else is derived from the built-in defaults and rc.xml,
+	 * so the parsed key/value pairs plus any asset that had to be
+	 * decoded or rendered afresh cover all changes.
+	 */
+	return theme->digest != old_digest
+		|| theme_cache.stats.misses != old_misses;
 }
 
 void
 theme_finish(struct theme *theme)
 {
-	wlr_buffer_drop(&theme->corner_top_left_active_normal->base);
-	wlr_buffer_drop(&theme->corner_top_left_inactive_normal->base);
-	wlr_buffer_drop(&theme->corner_top_right_active_normal->base);
-	wlr_buffer_drop(&theme->corner_top_right_inactive_normal->base);
+	/* The buffers themselves are owned by theme_cache */
 	theme->corner_top_left_active_normal = NULL;
 	theme->corner_top_left_inactive_normal = NULL;
 	theme->corner_top_right_active_normal = NULL;
 	theme->corner_top_right_inactive_normal = NULL;
 }
+
+void
+theme_cache_get_stats(struct theme_cache_stats *stats)
+{
+	*stats = theme_cache.stats;
+	stats->entries = theme_cache.assets.next
+		? wl_list_length(&theme_cache.assets) : 0;
+}
+
+void
+theme_cache_finish(void)
+{
+	if (!theme_cache.assets.next) {
+		return;
+	}
+	struct theme_asset *asset, *tmp;
+	wl_list_for_each_safe(asset, tmp, &theme_cache.assets, link) {
+		asset_destroy(asset);
+	}
+}
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <wlr/util/log.h>
+#include "trace.h"
+
+/* Number of most recent events kept, must be a power of two */
+#define TRACE_RING_SIZE 65536
+
+struct trace_event {
+	const char *name;
+	uint64_t start;    /* ns */
+	uint64_t duration; /* ns */
+};
+
+/*
+ * Writers claim a slot by bumping @head, so no locks are involved. The
+ * slot is reduced modulo the ring size and the oldest events get
+ * overwritten.
+ */
+static struct {
+	struct trace_event events[TRACE_RING_SIZE];
+	atomic_uint_fast64_t head;
+	unsigned int nr_dumps;
+} ring;
+
+uint64_t
+trace_now(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+void
+trace_scope_end(struct trace_scope *scope)
+{
+	uint64_t end = trace_now();
+	uint64_t slot = atomic_fetch_add_explicit(&ring.head, 1,
+		memory_order_relaxed);
+	struct trace_event *event = &ring.events[slot & (TRACE_RING_SIZE - 1)];
+	event->name = scope->name;
+	event->start = scope->start;
+	event->duration = end - scope->start;
+}
+
+void
+trace_dump(void)
+{
+	const char *dir = getenv("XDG_RUNTIME_DIR");
+	int pid = getpid();
+	char path[4096];
+	snprintf(path, sizeof(path), "%s/labwc-trace-%d-%u.json",
+		dir ? dir : "/tmp", pid, ++ring.nr_dumps);
+
+	FILE *f = fopen(path, "w");
+	if (!f) {
+		wlr_log_errno(WLR_ERROR, "cannot write trace to %s", path);
+		return;
+	}
+
+	uint64_t head = atomic_load_explicit(&ring.head, memory_order_relaxed);
+	uint64_t first = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+
+	/* Complete events ("ph":"X") with timestamps in microseconds */
+	fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	for (uint64_t i = first; i < head; i++) {
+		struct trace_event *event =
+			&ring.events[i & (TRACE_RING_SIZE - 1)];
+		fprintf(f, "%s{\"name\":\"%s\",\"cat\":\"labwc\",\"ph\":\"X\","
+			"\"pid\":%d,\"tid\":%d,\"ts\":%" PRIu64 ".%03u,"
+			"\"dur\":%" PRIu64 ".%03u}\n", i == first ? "" : ",",
+			event->name, pid, pid,
+			event->start / 1000, (unsigned int)(event->start % 1000),
+			event->duration / 1000,
+			(unsigned int)(event->duration % 1000));
+	}
+	fprintf(f, "]}\n");
+	fclose(f);
+
+	wlr_log(WLR_INFO, "wrote %" PRIu64 " trace events to %s",
+		head - first, path);
+}
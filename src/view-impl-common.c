@@ -13,6 +13,11 @@ view_impl_move_to_front(struct view *view)
 {
 	wl_list_remove(&view->link);
 	wl_list_insert(&view->server->views, &view->link);
+	if (view->visible_on_all_workspaces) {
+		wl_list_remove(&view->omnipresent_link);
+		wl_list_insert(&view->server->views_omnipresent,
+			&view->omnipresent_link);
+	}
 	wlr_scene_node_raise_to_top(&view->scene_tree->node);
 }
 
@@ -21,6 +26,11 @@ view_impl_move_to_back(struct view *view)
 {
 	wl_list_remove(&view->link);
 	wl_list_append(&view->server->views, &view->link);
+	if (view->visible_on_all_workspaces) {
+		wl_list_remove(&view->omnipresent_link);
+		wl_list_append(&view->server->views_omnipresent,
+			&view->omnipresent_link);
+	}
 	wlr_scene_node_lower_to_bottom(&view->scene_tree->node);
 }
 
@@ -39,7 +49,7 @@ view_impl_map(struct view *view)
 	 * map handlers, but the app_id/title might not have been set at that
 	 * point, so it's safer to process the property here
 	 */
-	enum property ret = window_rules_get_property(view, "skipTaskbar");
+	enum property ret = window_rules_get_property(view, LAB_RULE_PROP_SKIP_TASKBAR);
 	if (ret == LAB_PROP_TRUE) {
 		if (view->toplevel.handle) {
 			wlr_foreign_toplevel_handle_v1_destroy(view->toplevel.handle);
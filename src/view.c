@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
 #include <assert.h>
 #include <stdio.h>
+#include <time.h>
 #include <strings.h>
 #include "common/macros.h"
 #include "common/match.h"
@@ -10,6 +12,7 @@
 #include "labwc.h"
 #include "menu/menu.h"
 #include "regions.h"
+#include "resistance.h"
 #include "resize_indicator.h"
 #include "snap.h"
 #include "ssd.h"
@@ -67,20 +70,20 @@ view_matches_query(struct view *view, struct view_query *query)
 	const char *identifier = view_get_string_prop(view, "app_id");
 	if (match && query->identifier) {
 		empty = false;
-		match &= match_glob(query->identifier, identifier);
+		match &= glob_pattern_match(&query->identifier_glob, identifier);
 	}
 
 	const char *title = view_get_string_prop(view, "title");
 	if (match && query->title) {
 		empty = false;
-		match &= match_glob(query->title, title);
+		match &= glob_pattern_match(&query->title_glob, title);
 	}
 
 	return !empty && match;
 }
 
-static bool
-matches_criteria(struct view *view, enum lab_view_criteria criteria)
+bool
+view_matches_criteria(struct view *view, enum lab_view_criteria criteria)
 {
 	if (!view_is_focusable(view)) {
 		return false;
@@ -112,7 +115,8 @@ matches_criteria(struct view *view, enum lab_view_criteria criteria)
 		}
 	}
 	if (criteria & LAB_VIEW_CRITERIA_NO_SKIP_WINDOW_SWITCHER) {
-		if (window_rules_get_property(view, "skipWindowSwitcher") == LAB_PROP_TRUE) {
+		if (window_rules_get_property(view,
+				LAB_RULE_PROP_SKIP_WINDOW_SWITCHER) == LAB_PROP_TRUE) {
 			return false;
 		}
 	}
@@ -128,7 +132,7 @@ view_next(struct wl_list *head, struct view *view, enum lab_view_criteria criter
 
 	for (elm = elm->next; elm != head; elm = elm->next) {
 		view = wl_container_of(elm, view, link);
-		if (matches_criteria(view, criteria)) {
+		if (view_matches_criteria(view, criteria)) {
 			return view;
 		}
 	}
@@ -251,14 +255,29 @@ view_get_edge_snap_box(struct view *view, struct output *output,
 	return dst;
 }
 
+static void
+assign_output(struct view *view, struct output *output)
+{
+	if (view->output == output) {
+		return;
+	}
+	wl_list_remove(&view->output_link);
+	view->output = output;
+	if (output) {
+		wl_list_insert(&output->views, &view->output_link);
+	} else {
+		wl_list_init(&view->output_link);
+	}
+}
+
 static void
 view_discover_output(struct view *view)
 {
 	assert(view);
 	assert(!view->fullscreen);
-	view->output = output_nearest_to(view->server,
+	assign_output(view, output_nearest_to(view->server,
 		view->current.x + view->current.width / 2,
-		view->current.y + view->current.height / 2);
+		view->current.y + view->current.height / 2));
 }
 
 void
@@ -295,7 +314,7 @@ view_set_output(struct view *view, struct output *output)
 		wlr_log(WLR_ERROR, "invalid output set for view");
 		return;
 	}
-	view->output = output;
+	assign_output(view, output);
 }
 
 void
@@ -318,6 +337,45 @@ view_move(struct view *view, int x, int y)
 	});
 }
 
+static void
+box_union(struct wlr_box *dest, struct wlr_box *box)
+{
+	if (wlr_box_empty(box)) {
+		return;
+	}
+	if (wlr_box_empty(dest)) {
+		*dest = *box;
+		return;
+	}
+	int x1 = MIN(dest->x, box->x);
+	int y1 = MIN(dest->y, box->y);
+	int x2 = MAX(dest->x + dest->width, box->x + box->width);
+	int y2 = MAX(dest->y + dest->height, box->y + box->height);
+	*dest = (struct wlr_box){x1, y1, x2 - x1, y2 - y1};
+}
+
+void
+view_update_bounds(struct view *view)
+{
+	assert(view);
+	struct wlr_box bounds = ssd_max_extents(view);
+	if (view->ssd && !view->fullscreen
+			&& view->maximized != VIEW_AXIS_BOTH) {
+		/* Invisible resize area, see ssd_extents_update() */
+		bounds.x -= SSD_EXTENDED_AREA;
+		bounds.y -= SSD_EXTENDED_AREA;
+		bounds.width += 2 * SSD_EXTENDED_AREA;
+		bounds.height += 2 * SSD_EXTENDED_AREA;
+	}
+
+	struct wlr_box client = view->client_extents;
+	client.x += view->current.x;
+	client.y += view->current.y;
+	box_union(&bounds, &client);
+	view->bounds = bounds;
+	snap_update_view(view);
+}
+
 void
 view_moved(struct view *view)
 {
@@ -333,6 +391,7 @@ view_moved(struct view *view)
 		view_discover_output(view);
 	}
 	ssd_update_geometry(view->ssd);
+	view_update_bounds(view);
 	cursor_update_focus(view->server);
 	if (view->toplevel.handle) {
 		foreign_toplevel_update_outputs(view);
@@ -349,6 +408,7 @@ view_move_resize(struct view *view, struct wlr_box geo)
 	if (view->impl->configure) {
 		view->impl->configure(view, geo);
 	}
+	snap_update_view(view);
 }
 
 void
@@ -594,7 +654,7 @@ view_adjust_floating_geometry(struct view *view, struct wlr_box *geometry)
 	}
 
 	/* Avoid moving panels out of their own reserved area ("strut") */
-	if (window_rules_get_property(view, "fixedPosition") == LAB_PROP_TRUE
+	if (window_rules_get_property(view, LAB_RULE_PROP_FIXED_POSITION) == LAB_PROP_TRUE
 			|| view_has_strut_partial(view)) {
 		return false;
 	}
@@ -883,6 +943,7 @@ set_maximized(struct view *view, enum view_axis maximized)
 	 * up using an outdated ssd->margin to calculate offsets.
 	 */
 	ssd_update_margin(view->ssd);
+	snap_update_view(view);
 }
 
 /*
@@ -995,6 +1056,7 @@ view_toggle_decorations(struct view *view)
 		 */
 		view->ssd_titlebar_hidden = true;
 		ssd_titlebar_hide(view->ssd);
+		view_update_bounds(view);
 		if (!view_is_floating(view)) {
 			view_apply_special_geometry(view);
 		}
@@ -1011,17 +1073,46 @@ view_is_always_on_top(struct view *view)
 		view->server->view_tree_always_on_top;
 }
 
+/* Reparent the view and keep view->workspace_link in sync */
+static void
+reparent(struct view *view, struct wlr_scene_tree *tree)
+{
+	struct server *server = view->server;
+	wlr_scene_node_reparent(&view->scene_tree->node, tree);
+	wl_list_remove(&view->workspace_link);
+	if (tree == server->view_tree_always_on_top) {
+		wl_list_insert(&server->views_always_on_top, &view->workspace_link);
+	} else if (tree == view->workspace->tree) {
+		wl_list_insert(&view->workspace->views, &view->workspace_link);
+	} else {
+		wl_list_init(&view->workspace_link);
+	}
+}
+
+struct view *
+view_next_on_workspace(struct workspace *workspace, struct view *view)
+{
+	struct wl_list *always_on_top = &workspace->server->views_always_on_top;
+	struct wl_list *elm = view ? view->workspace_link.next : workspace->views.next;
+	if (elm == &workspace->views) {
+		/* Continue with always-on-top views */
+		elm = always_on_top->next;
+	}
+	if (elm == always_on_top) {
+		return NULL;
+	}
+	return wl_container_of(elm, view, workspace_link);
+}
+
 void
 view_toggle_always_on_top(struct view *view)
 {
 	assert(view);
 	if (view_is_always_on_top(view)) {
 		view->workspace = view->server->workspace_current;
-		wlr_scene_node_reparent(&view->scene_tree->node,
-			view->workspace->tree);
+		reparent(view, view->workspace->tree);
 	} else {
-		wlr_scene_node_reparent(&view->scene_tree->node,
-			view->server->view_tree_always_on_top);
+		reparent(view, view->server->view_tree_always_on_top);
 	}
 }
 
@@ -1039,11 +1130,9 @@ view_toggle_always_on_bottom(struct view *view)
 	assert(view);
 	if (view_is_always_on_bottom(view)) {
 		view->workspace = view->server->workspace_current;
-		wlr_scene_node_reparent(&view->scene_tree->node,
-			view->workspace->tree);
+		reparent(view, view->workspace->tree);
 	} else {
-		wlr_scene_node_reparent(&view->scene_tree->node,
-			view->server->view_tree_always_on_bottom);
+		reparent(view, view->server->view_tree_always_on_bottom);
 	}
 }
 
@@ -1052,6 +1141,21 @@ view_toggle_visible_on_all_workspaces(struct view *view)
 {
 	assert(view);
 	view->visible_on_all_workspaces = !view->visible_on_all_workspaces;
+	wl_list_remove(&view->omnipresent_link);
+	wl_list_init(&view->omnipresent_link);
+	if (view->visible_on_all_workspaces) {
+		/* Keep the order of server->views */
+		struct wl_list *head = &view->server->views;
+		struct wl_list *prev = &view->server->views_omnipresent;
+		for (struct wl_list *elm = view->link.prev; elm != head; elm = elm->prev) {
+			struct view *other = wl_container_of(elm, other, link);
+			if (other->visible_on_all_workspaces) {
+				prev = &other->omnipresent_link;
+				break;
+			}
+		}
+		wl_list_insert(prev, &view->omnipresent_link);
+	}
 }
 
 void
@@ -1061,8 +1165,7 @@ view_move_to_workspace(struct view *view, struct workspace *workspace)
 	assert(workspace);
 	if (view->workspace != workspace) {
 		view->workspace = workspace;
-		wlr_scene_node_reparent(&view->scene_tree->node,
-			workspace->tree);
+		reparent(view, workspace->tree);
 	}
 }
 
@@ -1072,6 +1175,7 @@ decorate(struct view *view)
 	if (!view->ssd) {
 		view->ssd = ssd_create(view,
 			view == view->server->active_view);
+		view_update_bounds(view);
 	}
 }
 
@@ -1080,6 +1184,7 @@ undecorate(struct view *view)
 {
 	ssd_destroy(view->ssd);
 	view->ssd = NULL;
+	view_update_bounds(view);
 }
 
 void
@@ -1226,7 +1331,7 @@ view_on_output_destroy(struct view *view)
 	 * view. We expect view_adjust_for_layout_change() to be called
 	 * shortly afterward, which will exit fullscreen.
 	 */
-	view->output = NULL;
+	assign_output(view, NULL);
 }
 
 static struct output *
@@ -1666,10 +1771,35 @@ view_get_string_prop(struct view *view, const char *prop)
 	return "";
 }
 
+static uint64_t
+get_msec(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static void
+title_update_cancel(struct view *view)
+{
+	if (view->title_update.idle) {
+		wl_event_source_remove(view->title_update.idle);
+		view->title_update.idle = NULL;
+	}
+	if (view->title_update.timer) {
+		wl_event_source_timer_update(view->title_update.timer, 0);
+	}
+	view->title_update.pending = false;
+}
+
 void
 view_update_title(struct view *view)
 {
 	assert(view);
+	title_update_cancel(view);
+	view->title_update.last_msec = get_msec();
+	window_rules_invalidate(view);
+	osd_schedule_update(view->server);
 	const char *title = view_get_string_prop(view, "title");
 	if (!view->toplevel.handle || !title) {
 		return;
@@ -1678,10 +1808,64 @@ view_update_title(struct view *view)
 	wlr_foreign_toplevel_handle_v1_set_title(view->toplevel.handle, title);
 }
 
+static void
+handle_title_update_idle(void *data)
+{
+	struct view *view = data;
+	/* Idle sources are removed automatically once dispatched */
+	view->title_update.idle = NULL;
+	view_update_title(view);
+}
+
+static int
+handle_title_update_timer(void *data)
+{
+	struct view *view = data;
+	view_update_title(view);
+	return 0; /* ignored per wl_event_loop docs */
+}
+
+void
+view_schedule_title_update(struct view *view)
+{
+	assert(view);
+	/* Window rules must see the new title right away */
+	window_rules_invalidate(view);
+	if (view->title_update.pending) {
+		return;
+	}
+
+	struct wl_event_loop *loop = view->server->wl_event_loop;
+	uint64_t now = get_msec();
+	uint64_t next = view->title_update.last_msec + rc.title_update_interval;
+	if (now >= next) {
+		/* Collapse the changes of the current event loop iteration */
+		view->title_update.idle = wl_event_loop_add_idle(loop,
+			handle_title_update_idle, view);
+		if (!view->title_update.idle) {
+			view_update_title(view);
+			return;
+		}
+	} else {
+		if (!view->title_update.timer) {
+			view->title_update.timer = wl_event_loop_add_timer(loop,
+				handle_title_update_timer, view);
+		}
+		if (!view->title_update.timer) {
+			view_update_title(view);
+			return;
+		}
+		wl_event_source_timer_update(view->title_update.timer,
+			next - now);
+	}
+	view->title_update.pending = true;
+}
+
 void
 view_update_app_id(struct view *view)
 {
 	assert(view);
+	window_rules_invalidate(view);
 	const char *app_id = view_get_string_prop(view, "app_id");
 	if (!view->toplevel.handle || !app_id) {
 		return;
@@ -1785,16 +1969,27 @@ view_destroy(struct view *view)
 	wl_list_remove(&view->set_title.link);
 	wl_list_remove(&view->destroy.link);
 
+	title_update_cancel(view);
+	if (view->title_update.timer) {
+		wl_event_source_remove(view->title_update.timer);
+		view->title_update.timer = NULL;
+	}
+
 	if (view->toplevel.handle) {
 		wlr_foreign_toplevel_handle_v1_destroy(view->toplevel.handle);
 	}
 
+	/* matchOnce window rules of other views may depend on this view */
+	window_rules_invalidate(view);
+	snap_remove_view(view);
+
 	if (server->grabbed_view == view) {
 		/* Application got killed while moving around */
 		server->input_mode = LAB_INPUT_STATE_PASSTHROUGH;
 		server->grabbed_view = NULL;
 		need_cursor_update = true;
 		regions_hide_overlay(&server->seat);
+		resistance_finish();
 	}
 
 	if (server->active_view == view) {
@@ -1843,8 +2038,11 @@ view_destroy(struct view *view)
 		menu_close_root(server);
 	}
 
-	/* Remove view from server->views */
+	/* Remove view from server->views and the membership lists */
 	wl_list_remove(&view->link);
+	wl_list_remove(&view->workspace_link);
+	wl_list_remove(&view->output_link);
+	wl_list_remove(&view->omnipresent_link);
 	free(view);
 
 	if (need_cursor_update) {
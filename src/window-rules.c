@@ -13,6 +13,9 @@
 #include "view.h"
 #include "window-rules.h"
 
+/* Starts at 1 so that zero-initialized caches are never valid */
+static uint32_t rules_generation = 1;
+
 static bool
 other_instances_exist(struct view *self, const char *id, const char *title)
 {
@@ -55,18 +58,18 @@ view_matches_criteria(struct window_rule *rule, struct view *view)
 		if (!id || !title) {
 			return false;
 		}
-		return match_glob(rule->identifier, id)
-			&& match_glob(rule->title, title);
+		return glob_pattern_match(&rule->identifier_glob, id)
+			&& glob_pattern_match(&rule->title_glob, title);
 	} else if (rule->identifier) {
 		if (!id) {
 			return false;
 		}
-		return match_glob(rule->identifier, id);
+		return glob_pattern_match(&rule->identifier_glob, id);
 	} else if (rule->title) {
 		if (!title) {
 			return false;
 		}
-		return match_glob(rule->title, title);
+		return glob_pattern_match(&rule->title_glob, title);
 	} else {
 		wlr_log(WLR_ERROR, "rule has no identifier or title\n");
 		return false;
@@ -87,10 +90,31 @@ window_rules_apply(struct view *view, enum window_rule_event event)
 	}
 }
 
-enum property
-window_rules_get_property(struct view *view, const char *property)
+static enum property
+rule_get_property(struct window_rule *rule, enum window_rule_property property)
+{
+	switch (property) {
+	case LAB_RULE_PROP_SERVER_DECORATION:
+		return rule->server_decoration;
+	case LAB_RULE_PROP_SKIP_TASKBAR:
+		return rule->skip_taskbar;
+	case LAB_RULE_PROP_SKIP_WINDOW_SWITCHER:
+		return rule->skip_window_switcher;
+	case LAB_RULE_PROP_IGNORE_FOCUS_REQUEST:
+		return rule->ignore_focus_request;
+	case LAB_RULE_PROP_FIXED_POSITION:
+		return rule->fixed_position;
+	default:
+		return LAB_PROP_UNSPECIFIED;
+	}
+}
+
+static uint32_t
+resolve_properties(struct view *view)
 {
-	assert(property);
+	uint32_t properties = 0;
+	uint32_t resolved = 0;
+	const uint32_t all = (1u << LAB_RULE_PROP_COUNT) - 1;
 
 	/*
 	 * We iterate in reverse here because later items in list have higher
@@ -104,34 +128,60 @@ window_rules_get_property(struct view *view, const char *property)
 	 */
 	struct window_rule *rule;
 	wl_list_for_each_reverse(rule, &rc.window_rules, link) {
-		/*
-		 * Only return if property != LAB_PROP_UNSPECIFIED otherwise a
-		 * <windowRule> which does not set a particular property
-		 * attribute would still return here if that property was asked
-		 * for.
-		 */
-		if (view_matches_criteria(rule, view)) {
-			if (rule->server_decoration
-					&& !strcasecmp(property, "serverDecoration")) {
-				return rule->server_decoration;
-			}
-			if (rule->skip_taskbar
-					&& !strcasecmp(property, "skipTaskbar")) {
-				return rule->skip_taskbar;
-			}
-			if (rule->skip_window_switcher
-					&& !strcasecmp(property, "skipWindowSwitcher")) {
-				return rule->skip_window_switcher;
-			}
-			if (rule->ignore_focus_request
-					&& !strcasecmp(property, "ignoreFocusRequest")) {
-				return rule->ignore_focus_request;
-			}
-			if (rule->fixed_position
-					&& !strcasecmp(property, "fixedPosition")) {
-				return rule->fixed_position;
+		if (resolved == all) {
+			break;
+		}
+		if (!view_matches_criteria(rule, view)) {
+			continue;
+		}
+		for (int i = 0; i < LAB_RULE_PROP_COUNT; i++) {
+			/*
+			 * Only take the value if != LAB_PROP_UNSPECIFIED
+			 * otherwise a <windowRule> which does not set a
+			 * particular property attribute would still override
+			 * earlier rules that do.
+			 */
+			enum property value = rule_get_property(rule, i);
+			if ((resolved & (1u << i)) || !value) {
+				continue;
 			}
+			properties |= (uint32_t)value << (2 * i);
+			resolved |= 1u << i;
 		}
 	}
-	return LAB_PROP_UNSPECIFIED;
+	return properties;
+}
+
+enum property
+window_rules_get_property(struct view *view, enum window_rule_property property)
+{
+	assert(property < LAB_RULE_PROP_COUNT);
+
+	struct window_rules_cache *cache = &view->rules_cache;
+	if (cache->generation != rules_generation) {
+		cache->properties = resolve_properties(view);
+		cache->generation = rules_generation;
+	}
+	return (cache->properties >> (2 * property)) & 0x3;
+}
+
+void
+window_rules_invalidate(struct view *view)
+{
+	bool match_once = false;
+	struct window_rule *rule;
+	wl_list_for_each(rule, &rc.window_rules, link) {
+		if (rule->match_once) {
+			match_once = true;
+			break;
+		}
+	}
+
+	if (view && !match_once) {
+		view->rules_cache.generation = 0;
+		return;
+	}
+	if (++rules_generation == 0) {
+		rules_generation = 1;
+	}
 }
@@ -180,6 +180,7 @@ add_workspace(struct server *server, const char *name)
 	workspace->server = server;
 	workspace->name = xstrdup(name);
 	workspace->tree = wlr_scene_tree_create(server->view_tree);
+	wl_list_init(&workspace->views);
 	wl_list_append(&server->workspaces, &workspace->link);
 	if (!server->workspace_current) {
 		server->workspace_current = workspace;
@@ -288,10 +289,8 @@ workspaces_switch_to(struct workspace *target, bool update_focus)
 
 	/* Move Omnipresent views to new workspace */
 	struct view *view;
-	enum lab_view_criteria criteria =
-		LAB_VIEW_CRITERIA_CURRENT_WORKSPACE;
-	for_each_view(view, &server->views, criteria) {
-		if (view->visible_on_all_workspaces) {
+	wl_list_for_each(view, &server->views_omnipresent, omnipresent_link) {
+		if (view_matches_criteria(view, LAB_VIEW_CRITERIA_CURRENT_WORKSPACE)) {
 			view_move_to_workspace(view, target);
 		}
 	}
@@ -1,5 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
 #include <assert.h>
+#include <time.h>
 #include "common/macros.h"
 #include "common/mem.h"
 #include "decorations.h"
@@ -49,11 +51,33 @@ handle_new_popup(struct wl_listener *listener, void *data)
 	xdg_popup_create(view, wlr_popup);
 }
 
+static uint64_t
+get_usec(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static void
+update_configure_stats(struct view *view)
+{
+	struct configure_stats *stats = &view->configure_stats;
+	if (!stats->sent_usec) {
+		return;
+	}
+	uint64_t rtt = get_usec() - stats->sent_usec;
+	stats->count++;
+	stats->total_usec += rtt;
+	stats->max_usec = MAX(stats->max_usec, rtt);
+	stats->sent_usec = 0;
+}
+
 static bool
 has_ssd(struct view *view)
 {
 	/* Window-rules take priority if they exist for this view */
-	switch (window_rules_get_property(view, "serverDecoration")) {
+	switch (window_rules_get_property(view, LAB_RULE_PROP_SERVER_DECORATION)) {
 	case LAB_PROP_TRUE:
 		return true;
 	case LAB_PROP_FALSE:
@@ -121,12 +145,25 @@ handle_commit(struct wl_listener *listener, void *data)
 		wl_event_source_remove(view->pending_configure_timeout);
 		view->pending_configure_serial = 0;
 		view->pending_configure_timeout = NULL;
+		update_configure_stats(view);
 		update_required = true;
+		if (view->resize_queue.queued) {
+			/* The ack may carry no damage, so ask for a frame */
+			interactive_resize_queue(view,
+				view->resize_queue.geometry);
+		}
 	}
 
 	if (update_required) {
 		view_impl_apply_geometry(view, size.width, size.height);
 	}
+
+	/* The surface is placed such that the window geometry is at 0,0 */
+	struct wlr_box *extents = &view->client_extents;
+	wlr_surface_get_extends(view->surface, extents);
+	extents->x -= xdg_surface->current.geometry.x;
+	extents->y -= xdg_surface->current.geometry.y;
+	view_update_bounds(view);
 }
 
 static int
@@ -143,10 +180,17 @@ handle_configure_timeout(void *data)
 	wl_event_source_remove(view->pending_configure_timeout);
 	view->pending_configure_serial = 0;
 	view->pending_configure_timeout = NULL;
+	view->configure_stats.sent_usec = 0;
+	view->configure_stats.timeouts++;
 
 	view_impl_apply_geometry(view, view->current.width,
 		view->current.height);
 
+	/* Send the resize queued while waiting for the ack */
+	if (view->resize_queue.queued) {
+		interactive_resize_queue(view, view->resize_queue.geometry);
+	}
+
 	return 0; /* ignored per wl_event_loop docs */
 }
 
@@ -154,6 +198,9 @@ static void
 set_pending_configure_serial(struct view *view, uint32_t serial)
 {
 	view->pending_configure_serial = serial;
+	if (!view->configure_stats.sent_usec) {
+		view->configure_stats.sent_usec = get_usec();
+	}
 	if (!view->pending_configure_timeout) {
 		view->pending_configure_timeout =
 			wl_event_loop_add_timer(view->server->wl_event_loop,
@@ -265,7 +312,7 @@ static void
 handle_set_title(struct wl_listener *listener, void *data)
 {
 	struct view *view = wl_container_of(listener, view, set_title);
-	view_update_title(view);
+	view_schedule_title_update(view);
 }
 
 static void
@@ -588,7 +635,7 @@ xdg_activation_handle_request(struct wl_listener *listener, void *data)
 	 * for the seat / serial being correct and then allow the request.
 	 */
 
-	if (window_rules_get_property(view, "ignoreFocusRequest") == LAB_PROP_TRUE) {
+	if (window_rules_get_property(view, LAB_RULE_PROP_IGNORE_FOCUS_REQUEST) == LAB_PROP_TRUE) {
 		wlr_log(WLR_INFO, "Ignoring focus request due to window rule configuration");
 		return;
 	}
@@ -690,6 +737,9 @@ xdg_surface_new(struct wl_listener *listener, void *data)
 	CONNECT_SIGNAL(xdg_surface, xdg_toplevel_view, new_popup);
 
 	wl_list_insert(&server->views, &view->link);
+	wl_list_insert(&view->workspace->views, &view->workspace_link);
+	wl_list_init(&view->output_link);
+	wl_list_init(&view->omnipresent_link);
 }
 
 void
@@ -2,6 +2,7 @@
 #define _POSIX_C_SOURCE 200809L
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 #include <wlr/xwayland.h>
 #include "common/array.h"
 #include "common/macros.h"
@@ -169,7 +170,7 @@ want_deco(struct wlr_xwayland_surface *xwayland_surface)
 	struct view *view = (struct view *)xwayland_surface->data;
 
 	/* Window-rules take priority if they exist for this view */
-	switch (window_rules_get_property(view, "serverDecoration")) {
+	switch (window_rules_get_property(view, LAB_RULE_PROP_SERVER_DECORATION)) {
 	case LAB_PROP_TRUE:
 		return true;
 	case LAB_PROP_FALSE:
@@ -201,6 +202,9 @@ handle_commit(struct wl_listener *listener, void *data)
 	if (current->width != state->width || current->height != state->height) {
 		view_impl_apply_geometry(view, state->width, state->height);
 	}
+
+	wlr_surface_get_extends(view->surface, &view->client_extents);
+	view_update_bounds(view);
 }
 
 static void
@@ -300,6 +304,11 @@ handle_destroy(struct wl_listener *listener, void *data)
 	wl_list_remove(&xwayland_view->set_decorations.link);
 	wl_list_remove(&xwayland_view->set_override_redirect.link);
 	wl_list_remove(&xwayland_view->set_strut_partial.link);
+	if (!wl_list_empty(&xwayland_view->strut_link)) {
+		wl_list_remove(&xwayland_view->strut_link);
+		wl_list_init(&xwayland_view->strut_link);
+		view->server->strut_serial++;
+	}
 
 	view_destroy(view);
 }
@@ -363,7 +372,7 @@ handle_request_activate(struct wl_listener *listener, void *data)
 		wl_container_of(listener, xwayland_view, request_activate);
 	struct view *view = &xwayland_view->base;
 
-	if (window_rules_get_property(view, "ignoreFocusRequest") == LAB_PROP_TRUE) {
+	if (window_rules_get_property(view, LAB_RULE_PROP_IGNORE_FOCUS_REQUEST) == LAB_PROP_TRUE) {
 		wlr_log(WLR_INFO, "Ignoring focus request due to window rule configuration");
 		return;
 	}
@@ -410,7 +419,7 @@ static void
 handle_set_title(struct wl_listener *listener, void *data)
 {
 	struct view *view = wl_container_of(listener, view, set_title);
-	view_update_title(view);
+	view_schedule_title_update(view);
 }
 
 static void
@@ -483,16 +492,47 @@ handle_set_override_redirect(struct wl_listener *listener, void *data)
 	xwayland_unmanaged_create(server, xsurface, mapped);
 }
 
+/*
+ * Keep server->strut_views in sync with the view's mapped state and
+ * _NET_WM_STRUT_PARTIAL, and update the usable areas only if the set of
+ * struts actually changed.
+ */
 static void
-handle_set_strut_partial(struct wl_listener *listener, void *data)
+update_strut(struct xwayland_view *xwayland_view)
 {
-	struct xwayland_view *xwayland_view =
-		wl_container_of(listener, xwayland_view, set_strut_partial);
 	struct view *view = &xwayland_view->base;
+	struct server *server = view->server;
+	xcb_ewmh_wm_strut_partial_t *strut = view->mapped
+		? xwayland_view->xwayland_surface->strut_partial : NULL;
+	bool linked = !wl_list_empty(&xwayland_view->strut_link);
 
-	if (view->mapped) {
-		output_update_all_usable_areas(view->server, false);
+	if (strut) {
+		if (linked && !memcmp(strut, &xwayland_view->strut,
+				sizeof(*strut))) {
+			return;
+		}
+		xwayland_view->strut = *strut;
+		if (!linked) {
+			wl_list_append(&server->strut_views,
+				&xwayland_view->strut_link);
+		}
+	} else {
+		if (!linked) {
+			return;
+		}
+		wl_list_remove(&xwayland_view->strut_link);
+		wl_list_init(&xwayland_view->strut_link);
 	}
+	server->strut_serial++;
+	output_update_all_usable_areas(server, false);
+}
+
+static void
+handle_set_strut_partial(struct wl_listener *listener, void *data)
+{
+	struct xwayland_view *xwayland_view =
+		wl_container_of(listener, xwayland_view, set_strut_partial);
+	update_strut(xwayland_view);
 }
 
 static void
@@ -639,9 +679,7 @@ xwayland_view_map(struct view *view)
 	view->been_mapped = true;
 
 	/* Update usable area to account for XWayland "struts" (panels) */
-	if (xwayland_surface->strut_partial) {
-		output_update_all_usable_areas(view->server, false);
-	}
+	update_strut(xwayland_view_from_view(view));
 }
 
 static void
@@ -656,9 +694,7 @@ xwayland_view_unmap(struct view *view, bool client_request)
 	view_impl_unmap(view);
 
 	/* Update usable area to account for XWayland "struts" (panels) */
-	if (xwayland_surface_from_view(view)->strut_partial) {
-		output_update_all_usable_areas(view->server, false);
-	}
+	update_strut(xwayland_view_from_view(view));
 
 	/*
 	 * If the view was explicitly unmapped by the client (rather
@@ -852,6 +888,10 @@ xwayland_view_create(struct server *server,
 	CONNECT_SIGNAL(xsurface, xwayland_view, set_strut_partial);
 
 	wl_list_insert(&view->server->views, &view->link);
+	wl_list_insert(&view->workspace->views, &view->workspace_link);
+	wl_list_init(&view->output_link);
+	wl_list_init(&view->omnipresent_link);
+	wl_list_init(&xwayland_view->strut_link);
 
 	if (mapped) {
 		xwayland_view_map(view);
@@ -1004,11 +1044,11 @@ xwayland_adjust_usable_area(struct view *view, struct wlr_output_layout *layout,
 		return;
 	}
 
-	xcb_ewmh_wm_strut_partial_t *strut =
-		xwayland_surface_from_view(view)->strut_partial;
-	if (!strut) {
+	struct xwayland_view *xwayland_view = xwayland_view_from_view(view);
+	if (wl_list_empty(&xwayland_view->strut_link)) {
 		return;
 	}
+	xcb_ewmh_wm_strut_partial_t *strut = &xwayland_view->strut;
 
 	/* these are layout coordinates */
 	struct wlr_box lb = { 0 };